@@ -1128,6 +1128,15 @@ public:
         break;
       }
 
+    /* Determine if it can also be read from a FastReader */
+    bool isFastReadDNA = false;
+    for (const clang::CXXMethodDecl* method : decl->methods())
+      if (method->getDeclName().isIdentifier() && method->getName() == "read" && method->getNumParams() == 1 &&
+          method->getParamDecl(0)->getType().getAsString() == "athena::io::FastReaderBase &") {
+        isFastReadDNA = true;
+        break;
+      }
+
     /* Determine if this is a regular DNA or PropDNA */
     bool isPropDNA = false;
     for (const clang::Decl* d : decl->decls())
@@ -1170,6 +1179,9 @@ public:
       for (const auto& specialization : specializations)
         fileOut << "AT_SPECIALIZE_DNA(" << specialization.first << ")\n";
     }
+    if (isFastReadDNA && !isPropDNA)
+      for (const auto& specialization : specializations)
+        fileOut << "AT_SPECIALIZE_DNA_FAST_READ(" << specialization.first << ")\n";
     fileOut << "\n\n";
 
     for (const auto& specialization : specializations) {
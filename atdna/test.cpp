@@ -1,10 +1,52 @@
 #include "test.hpp"
 
+#include <athena/FastReader.hpp>
 #include <athena/MemoryWriter.hpp>
 #include <fmt/format.h>
 
 #define EXPECTED_BYTES 281
 
+static bool testFastRead() {
+  TESTFastReadFile file = {};
+  file.magic = 0x46415354;
+  file.entryCount = 2;
+  file.entries.resize(2);
+  file.entries[0].id = 7;
+  file.entries[0].weight = 0.5f;
+  file.entries[0].name = "first";
+  file.entries[1].id = 300;
+  file.entries[1].weight = -2.f;
+  file.entries[1].name = "second";
+  file.valueCount = 3;
+  file.values = {1, 0x10000, 0xDEADBEEF};
+  file.tag = "fasttag";
+  size_t binSize = 0;
+  file.binarySize(binSize);
+  athena::io::MemoryCopyWriter w(nullptr, binSize);
+  file.write(w);
+  const atUint64 written = w.position();
+  auto data = w.release();
+
+  TESTFastReadFile read;
+  athena::io::FastReader<athena::Endian::Big> r(data.get(), written);
+  read.read(r);
+
+  bool match = read.magic == file.magic && read.entries.size() == file.entries.size() && read.values == file.values &&
+               read.tag == file.tag;
+  for (size_t i = 0; match && i < read.entries.size(); ++i)
+    match = read.entries[i].id == file.entries[i].id && read.entries[i].weight == file.entries[i].weight &&
+            read.entries[i].name == file.entries[i].name;
+
+  const bool pass = !w.hasError() && !r.hasError() && r.position() == written && match;
+  if (pass) {
+    fmt::print(FMT_STRING("[PASS] {} bytes read with FastRead\n"), size_t(r.position()));
+  } else {
+    fmt::print(FMT_STRING("[FAIL] {} of {} bytes read with FastRead; fields match: {}\n"), size_t(r.position()),
+               size_t(written), match);
+  }
+  return pass;
+}
+
 int main(int argc, const char** argv) {
   TESTFile<atUint32, 2> file = {};
   file.arrCount[0] = 2;
@@ -24,5 +66,5 @@ int main(int argc, const char** argv) {
                EXPECTED_BYTES);
   }
 
-  return pass ? 0 : 1;
+  return pass && testFastRead() ? 0 : 1;
 }
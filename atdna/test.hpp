@@ -71,3 +71,24 @@ struct AT_SPECIALIZE_PARMS(atUint16, 42, atUint32, 87, atUint32, 2) TESTFile : p
   String<32> str;
   WString<64> wstr;
 };
+
+struct TESTFastReadFile : public BigDNA {
+  AT_DECL_DNA
+  AT_DECL_FAST_READ
+  Value<atUint32> magic;
+
+  struct TESTFastReadEntry : public BigDNA {
+    AT_DECL_DNA
+    AT_DECL_FAST_READ
+    Value<atUint16> id;
+    Value<float> weight;
+    String<> name;
+  };
+  Value<atUint32> entryCount;
+  Vector<TESTFastReadEntry, AT_DNA_COUNT(entryCount)> entries;
+
+  Value<atUint32> valueCount;
+  Vector<atUint32, AT_DNA_COUNT(valueCount)> values;
+
+  String<8> tag;
+};
@@ -0,0 +1,234 @@
+// Measures compression ratio and compress / decompress throughput of every codec in
+// athena/Compression.hpp over a generated corpus, and prints the results as JSON.
+//
+// usage: athena-bench-compression [size in bytes] [repeats]
+
+#include <athena/Compression.hpp>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace athena::io;
+
+namespace {
+using Bytes = std::vector<atUint8>;
+
+struct Corpus {
+  std::string name;
+  Bytes data;
+};
+
+struct BenchCodec {
+  std::string name;
+  // Returns false if the codec gave up on the input
+  std::function<bool(const Bytes& src, Bytes& dst)> compress;
+  std::function<bool(const Bytes& src, Bytes& dst)> decompress;
+};
+
+// English-like words, punctuation and line breaks
+Bytes makeText(size_t size, std::mt19937& rng) {
+  static const char* const Words[] = {"the",  "of",    "and",   "to",     "a",     "in",    "is",   "with",
+                                      "link", "quest", "sword", "shield", "heart", "rupee", "item", "dungeon",
+                                      "boss", "key",   "map",   "temple", "cave",  "water", "fire", "compass"};
+  Bytes out;
+  out.reserve(size + 16);
+  std::geometric_distribution<int> sentence(0.08);
+  while (out.size() < size) {
+    const int words = sentence(rng) + 3;
+    for (int i = 0; i < words; ++i) {
+      const char* word = Words[rng() % std::size(Words)];
+      out.insert(out.end(), word, word + strlen(word));
+      out.push_back(i + 1 == words ? '.' : ' ');
+    }
+    out.push_back(rng() % 4 ? ' ' : '\n');
+  }
+  out.resize(size);
+  return out;
+}
+
+// Fixed-size big-endian records with counters, flags and a few recurring values, like DNA tables
+Bytes makeTables(size_t size, std::mt19937& rng) {
+  Bytes out;
+  out.reserve(size + 32);
+  const atUint32 values[] = {0, 1, 0x3F800000, 0xFFFFFFFF, 0x42C80000, 100};
+  for (atUint32 id = 0; out.size() < size; ++id) {
+    const atUint32 fields[] = {0x10000000 + id, values[rng() % std::size(values)], id * 0x20, atUint32(rng() % 8),
+                               values[rng() % std::size(values)], 0, 0, 0};
+    for (atUint32 field : fields)
+      for (int shift = 24; shift >= 0; shift -= 8)
+        out.push_back(atUint8(field >> shift));
+  }
+  out.resize(size);
+  return out;
+}
+
+Bytes makeRandom(size_t size, std::mt19937& rng) {
+  Bytes out(size);
+  for (atUint8& b : out)
+    b = atUint8(rng());
+  return out;
+}
+
+// 256-pixel-wide RGB565 image of smooth gradients with a little noise
+Bytes makeTexture(size_t size, std::mt19937& rng) {
+  Bytes out;
+  out.reserve(size + 2);
+  std::normal_distribution<float> noise(0.f, 1.f);
+  for (size_t px = 0; out.size() < size; ++px) {
+    const float x = float(px % 256) / 256.f;
+    const float y = float(px / 256 % 256) / 256.f;
+    const auto channel = [&](float v, int max) {
+      return atUint16(std::clamp(int(v * float(max) + noise(rng)), 0, max));
+    };
+    const atUint16 r = channel(0.5f + 0.5f * std::sin(x * 6.f + y * 2.f), 31);
+    const atUint16 g = channel(y, 63);
+    const atUint16 b = channel(0.5f + 0.5f * std::cos(y * 5.f - x * 3.f), 31);
+    const atUint16 texel = atUint16(r << 11 | g << 5 | b);
+    out.push_back(atUint8(texel >> 8));
+    out.push_back(atUint8(texel));
+  }
+  out.resize(size);
+  return out;
+}
+
+void addZlibCodec(std::vector<BenchCodec>& codecs, atInt32 level) {
+  codecs.push_back({fmt::format(FMT_STRING("zlib-{}"), level),
+                    [level](const Bytes& src, Bytes& dst) {
+                      dst.resize(src.size() + src.size() / 8 + 64);
+                      const atInt32 ret = Compression::compressZlib(src.data(), atUint32(src.size()), dst.data(),
+                                                                    atUint32(dst.size()), level);
+                      dst.resize(std::max(ret, 0));
+                      return ret > 0;
+                    },
+                    [](const Bytes& src, Bytes& dst) {
+                      return Compression::decompressZlib(src.data(), atUint32(src.size()), dst.data(),
+                                                         atUint32(dst.size())) == atInt32(dst.size());
+                    }});
+}
+
+std::vector<BenchCodec> makeCodecs() {
+  std::vector<BenchCodec> codecs;
+  for (atInt32 level : {1, 6, 9})
+    addZlibCodec(codecs, level);
+
+  codecs.push_back({"zlib-parallel-6",
+                    [](const Bytes& src, Bytes& dst) {
+                      dst = Compression::compressZlibParallel(src.data(), src.size(), 6);
+                      return !dst.empty();
+                    },
+                    [](const Bytes& src, Bytes& dst) {
+                      return Compression::decompressZlib(src.data(), atUint32(src.size()), dst.data(),
+                                                         atUint32(dst.size())) == atInt32(dst.size());
+                    }});
+
+  for (atInt32 level : {1, 9}) {
+    codecs.push_back({fmt::format(FMT_STRING("yaz0-{}"), level),
+                      [level](const Bytes& src, Bytes& dst) {
+                        Compression::Yaz0Encoder encoder(level);
+                        dst.resize(Compression::Yaz0Encoder::maxEncodedSize(atUint32(src.size())));
+                        dst.resize(encoder.encode(src.data(), atUint32(src.size()), dst.data()));
+                        return true;
+                      },
+                      [](const Bytes& src, Bytes& dst) {
+                        return Compression::yaz0Decode(src.data(), atUint32(src.size()), dst.data(),
+                                                       atUint32(dst.size())) == atInt64(dst.size());
+                      }});
+  }
+
+  for (bool extended : {false, true}) {
+    codecs.push_back({extended ? "lz77-11" : "lz77-10",
+                      [extended](const Bytes& src, Bytes& dst) {
+                        atUint8* out = nullptr;
+                        const atUint32 len =
+                            Compression::compressLZ77(src.data(), atUint32(src.size()), &out, extended);
+                        dst.assign(out, out + len);
+                        delete[] out;
+                        return len > 0;
+                      },
+                      [](const Bytes& src, Bytes& dst) {
+                        return Compression::decompressLZ77Into(src.data(), atUint32(src.size()), dst.data(),
+                                                               atUint32(dst.size())) == dst.size();
+                      }});
+  }
+
+#if AT_LZOKAY
+  codecs.push_back({"lzo",
+                    [](const Bytes& src, Bytes& dst) {
+                      dst.resize(Compression::LZOEncoder::maxEncodedSize(atUint32(src.size())));
+                      const atInt32 ret = Compression::compressLZO(src.data(), atUint32(src.size()), dst.data(),
+                                                                   atUint32(dst.size()));
+                      dst.resize(std::max(ret, 0));
+                      return ret > 0;
+                    },
+                    [](const Bytes& src, Bytes& dst) {
+                      atInt32 remaining = atInt32(dst.size());
+                      return Compression::decompressLZO(src.data(), atInt32(src.size()), dst.data(), remaining) >= 0 &&
+                             remaining == 0;
+                    }});
+#endif
+
+  return codecs;
+}
+
+// Runs f repeats times and returns the fastest run in seconds
+template <class F>
+double bestOf(int repeats, F&& f) {
+  double best = INFINITY;
+  for (int i = 0; i < repeats; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+  return best;
+}
+} // namespace
+
+int main(int argc, const char** argv) {
+  const size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 1 << 20;
+  const int repeats = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 3;
+
+  // A fixed seed keeps the corpus identical between runs, so results can be compared
+  std::mt19937 rng(0x41544841);
+  const Corpus corpora[] = {
+      {"text", makeText(size, rng)},
+      {"tables", makeTables(size, rng)},
+      {"random", makeRandom(size, rng)},
+      {"texture16", makeTexture(size, rng)},
+  };
+
+  fmt::print(FMT_STRING("{{\n  \"size\": {},\n  \"repeats\": {},\n  \"results\": ["), size, repeats);
+  bool first = true;
+  for (const BenchCodec& codec : makeCodecs()) {
+    for (const Corpus& corpus : corpora) {
+      Bytes compressed;
+      bool ok = true;
+      const double compressTime = bestOf(repeats, [&]() { ok = codec.compress(corpus.data, compressed) && ok; });
+
+      Bytes decompressed(corpus.data.size());
+      const double decompressTime =
+          ok ? bestOf(repeats, [&]() { ok = codec.decompress(compressed, decompressed) && ok; }) : 0.0;
+      ok = ok && decompressed == corpus.data;
+
+      const double mb = double(corpus.data.size()) / (1024.0 * 1024.0);
+      fmt::print(FMT_STRING("{}\n    {{\"codec\": \"{}\", \"corpus\": \"{}\", \"input\": {}, \"output\": {}, "
+                            "\"ratio\": {:.4f}, \"compress_mbps\": {:.2f}, \"decompress_mbps\": {:.2f}, "
+                            "\"roundtrip\": {}}}"),
+                 first ? "" : ",", codec.name, corpus.name, corpus.data.size(), compressed.size(),
+                 corpus.data.empty() ? 0.0 : double(compressed.size()) / double(corpus.data.size()),
+                 compressTime > 0.0 ? mb / compressTime : 0.0, ok && decompressTime > 0.0 ? mb / decompressTime : 0.0,
+                 ok);
+      first = false;
+    }
+  }
+  fmt::print(FMT_STRING("\n  ]\n}}\n"));
+
+  return 0;
+}
@@ -10,6 +10,11 @@ public:
 
   virtual atUint32 compress(const atUint8* src, atUint8** dest, atUint32 srcLength) = 0;
   virtual atUint32 decompress(const atUint8* src, atUint8** dest, atUint32 srcLength) = 0;
+  // Decodes into a caller-provided buffer; returns the decompressed size, or 0 if the input is bad or doesn't fit
+  virtual atUint32 decompressInto(const atUint8* src, atUint32 srcLength, atUint8* dst, atUint32 dstLength) = 0;
+
+  // Reads the decompressed size from the 4 (or, for large type 0x11 data, 8) byte header
+  static atUint32 decompressedSize(const atUint8* src);
 
   void setSlidingWindow(atInt32 SlidingWindow);
   atInt32 slidingWindow() const;
@@ -24,6 +29,7 @@ public:
 
 protected:
   LZLengthOffset search(const atUint8* posPtr, const atUint8* dataBegin, const atUint8* dataEnd) const;
+  static void copyMatch(atUint8* out, atUint32 offset, atUint32 length);
 
   atInt32 m_slidingWindow;
   atInt32 m_readAheadBuffer;
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstdint>
-#include <map>
 #include <vector>
 #include <athena/Types.hpp>
 
@@ -21,10 +20,16 @@ public:
   void setLookAheadWindow(atInt32 lookAheadWindow);
 
 private:
-  using LookupTable = std::multimap<std::vector<uint8_t>, int32_t>;
-  LookupTable table;
+  void reset(const atUint8* dataBegin);
+  void insert(const atUint8* dataBegin, const atUint8* dataEnd, atInt32 offset);
+  atUint32 hash(const atUint8* ptr) const;
+
   atInt32 m_minimumMatch = 3;
   atInt32 m_slidingWindow = 4096;
   atInt32 m_lookAheadWindow = 18;
-  std::vector<uint8_t> m_buffer;
+  // Hash chains over the sliding window: m_head holds the newest offset for each hash, and
+  // m_prev (indexed by offset modulo the window) the next older offset with the same hash
+  std::vector<atInt32> m_head;
+  std::vector<atInt32> m_prev;
+  const atUint8* m_dataBegin = nullptr;
 };
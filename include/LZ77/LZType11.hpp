@@ -8,4 +8,5 @@ public:
                     atInt32 BlockSize = 8);
   atUint32 compress(const atUint8* src, atUint8** dst, atUint32 srcLength) override;
   atUint32 decompress(const atUint8* src, atUint8** dst, atUint32 srcLength) override;
+  atUint32 decompressInto(const atUint8* src, atUint32 srcLength, atUint8* dst, atUint32 dstLength) override;
 };
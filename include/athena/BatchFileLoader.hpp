@@ -0,0 +1,61 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "athena/MemoryReader.hpp"
+
+namespace athena::io {
+/*! \class BatchFileLoader
+ *  \brief Loads many whole files into memory at once
+ *
+ *  On Linux the open/stat/read/close of every file is queued through io_uring,
+ *  so a batch of small files costs a handful of system calls instead of four per
+ *  file. Elsewhere, or when io_uring is unavailable, the files are loaded by a
+ *  pool of worker threads instead.
+ *
+ *  Files are handed over as they finish, not in the order they were given.
+ */
+class BatchFileLoader {
+public:
+  /*! \brief Called once per file on the thread that called load().
+   *
+   *  \param index  Index of the file in the list passed to load()
+   *  \param reader Reader owning the file contents, or nullptr if the file could not be read
+   */
+  using Callback = std::function<void(size_t index, std::unique_ptr<MemoryReader> reader)>;
+
+  /*! \brief Sets up the loader.
+   *
+   *   \param queueDepth  Number of io_uring submission entries, which bounds the files in flight
+   *   \param threadCount Worker threads used when io_uring is unavailable, 0 for hardware concurrency
+   *   \param globalErr   Whether or not global errors are enabled.
+   */
+  explicit BatchFileLoader(atUint32 queueDepth = 64, atUint32 threadCount = 0, bool globalErr = true);
+  ~BatchFileLoader();
+
+  BatchFileLoader(const BatchFileLoader&) = delete;
+  BatchFileLoader& operator=(const BatchFileLoader&) = delete;
+
+  /*! \brief Loads every file in paths, invoking callback as each one completes.
+   *
+   *  Returns once all files have been delivered.
+   */
+  void load(const std::vector<std::string>& paths, const Callback& callback);
+
+  /*! \brief Whether load() goes through io_uring rather than the thread pool. */
+  bool isUsingIoUring() const { return m_ring != nullptr; }
+
+private:
+  struct Ring;
+
+  void _loadRing(const std::vector<std::string>& paths, const Callback& callback);
+  void _loadThreaded(const std::vector<std::string>& paths, const Callback& callback);
+
+  std::unique_ptr<Ring> m_ring;
+  atUint32 m_threadCount;
+  bool m_globalErr;
+};
+} // namespace athena::io
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "athena/Types.hpp"
+
+namespace athena::io {
+/*! \class BufferPool
+ *  \brief A per-thread cache of byte buffers for loops that keep allocating and freeing them
+ *
+ *  Buffers are rounded up to a power of two and, once released, kept around for the next
+ *  acquire() of that size class instead of going back to the heap. The memory is never
+ *  zero-filled. Each thread has its own pool, reached through local() and not constructible
+ *  otherwise, so no locking is involved; a buffer released on another thread simply lands
+ *  in that thread's pool.
+ */
+class BufferPool {
+public:
+  /*! \brief Returns a buffer to the releasing thread's pool, or frees it if there is none. */
+  struct Deleter {
+    atUint64 capacity = 0;
+    void operator()(atUint8* ptr) const;
+  };
+  using Buffer = std::unique_ptr<atUint8[], Deleter>;
+
+  /*! \brief Buffers larger than this are allocated and freed directly. */
+  static constexpr atUint64 MaxPooledSize = atUint64(1) << 26;
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+  ~BufferPool();
+
+  /*! \brief Returns the calling thread's pool. */
+  static BufferPool& local();
+
+  /*! \brief Returns an uninitialized buffer of at least size bytes. */
+  Buffer acquire(atUint64 size);
+
+  /*! \brief Sets how many bytes of released buffers may be kept; 0 disables pooling. */
+  void setMaxCached(atUint64 bytes);
+  atUint64 maxCached() const { return m_maxCached; }
+  atUint64 cached() const { return m_cached; }
+
+  /*! \brief Frees every buffer currently kept by the pool. */
+  void trim();
+
+private:
+  static constexpr unsigned MinShift = 8;
+
+  // Only local() makes pools; Deleter hands buffers back to whichever one belongs to the freeing thread
+  BufferPool() = default;
+  static constexpr unsigned MaxShift = 26;
+
+  void _release(atUint8* ptr, atUint64 capacity);
+
+  std::array<std::vector<atUint8*>, MaxShift - MinShift + 1> m_free;
+  atUint64 m_maxCached = atUint64(64) << 20;
+  atUint64 m_cached = 0;
+};
+} // namespace athena::io
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "athena/IStreamWriter.hpp"
+
+namespace athena::io {
+/*! \class ChunkedWriter
+ *  \brief A Stream class that collects its output in a list of fixed-size chunks
+ *
+ *  Growing never reallocates or moves what was already written. Large payloads can be
+ *  attached by reference instead of copied, and the result comes out as a list of
+ *  slices that FileWriter::writeUBytesV or Socket::send hand to the OS in one call.
+ *
+ *  Seeking back and overwriting earlier data (e.g. to patch a header) works, except
+ *  inside attached payloads.
+ */
+class ChunkedWriter : public IStreamWriter {
+public:
+  /*! \brief Creates an empty writer.
+   *
+   *   \param chunkSize Size of each chunk that written data is copied into
+   *   \param globalErr Whether or not global errors are enabled.
+   */
+  explicit ChunkedWriter(atUint64 chunkSize = 64 * 1024, bool globalErr = true);
+
+  /*! \brief Sets the position relative to the specified origin.
+   *         Seeking past the end pads the output with zeros.
+   */
+  void seek(atInt64 position, SeekOrigin origin = SeekOrigin::Current) override;
+  atUint64 position() const override { return m_position; }
+  atUint64 length() const override { return m_length; }
+  void writeUBytes(const atUint8* data, atUint64 length) override;
+
+  /*! \brief Appends data by reference, without copying it.
+   *
+   *  The data must stay valid and unchanged for as long as the writer's slices are used.
+   *  The current position must be at the end; it is moved past the attached data.
+   */
+  void attach(const void* data, atUint64 length);
+
+  /*! \brief Appends data without copying it, taking ownership of the buffer. */
+  void attach(std::unique_ptr<atUint8[]> data, atUint64 length);
+
+  /*! \brief Returns the output as slices that add up to length() bytes, in order. */
+  const std::vector<atIoSlice>& slices() const { return m_slices; }
+
+  /*! \brief Writes the whole output to another stream with a single writeUBytesV call. */
+  void writeTo(IStreamWriter& writer) const { writer.writeUBytesV(m_slices.data(), m_slices.size()); }
+
+  /*! \brief Copies the whole output into dst, which must hold length() bytes. */
+  void copyTo(void* dst) const;
+
+  /*! \brief Drops everything written or attached so far. */
+  void clear();
+
+private:
+  void _append(const atUint8* data, atUint64 length);
+  void _overwrite(const atUint8* data, atUint64 length);
+
+  std::vector<atIoSlice> m_slices;
+  std::vector<atUint64> m_sliceOffsets; // stream offset of each slice
+  std::vector<bool> m_sliceAttached;
+  std::vector<std::unique_ptr<atUint8[]>> m_chunks;
+  std::vector<std::unique_ptr<atUint8[]>> m_ownedAttachments;
+  atUint64 m_chunkSize;
+  atUint64 m_chunkUsed = 0; // bytes used in m_chunks.back()
+  atUint64 m_position = 0;
+  atUint64 m_length = 0;
+  bool m_globalErr;
+};
+} // namespace athena::io
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "athena/Types.hpp"
+
+namespace athena::io {
+class IStreamWriter;
+}
+
+namespace athena::io::Compression {
+/*! \class Codec
+ *  \brief One compressed format behind a common decoding interface
+ *
+ *  Every decode returns the decoded size, or -1 if the input is corrupt or doesn't fit,
+ *  regardless of how the underlying Compression function reports it.
+ */
+class Codec {
+public:
+  virtual ~Codec() = default;
+
+  virtual std::string_view name() const = 0;
+
+  /*! \brief Whether src starts with this format's header. */
+  virtual bool detect(std::span<const atUint8> src) const = 0;
+
+  /*! \brief The decoded size stored in the header, or 0 if the format doesn't store one. */
+  virtual atUint64 decodedSize(std::span<const atUint8> src) const = 0;
+
+  /*! \brief Decodes src (header included) into dst. */
+  virtual atInt64 decode(std::span<const atUint8> src, atUint8* dst, atUint64 dstLen) const = 0;
+
+  /*! \brief Decodes src (header included) into writer.
+   *
+   *  A decodedSize of 0 takes the size from the header. The default implementation
+   *  decodes into a pooled buffer first, and fails without allocating if the size is more
+   *  than 0x4000 times the input; formats that can stream override it.
+   */
+  virtual atInt64 decode(std::span<const atUint8> src, IStreamWriter& writer, atUint64 decodedSize = 0) const;
+};
+
+/*! \class CodecRegistry
+ *  \brief Picks the Codec for a compressed blob by its header and decodes it
+ *
+ *  Built in are Yaz0, LZ77 (types 0x10 and 0x11), zlib, gzip and, with AT_LZOKAY, LZO.
+ *  LZO data has no header, so it can only be looked up by name.
+ *  Codecs added later are tried first, so a faster implementation of a format can
+ *  replace the built-in one without touching the call sites.
+ */
+class CodecRegistry {
+public:
+  /*! \brief Creates a registry, optionally holding the built-in codecs. */
+  explicit CodecRegistry(bool builtins = true);
+
+  /*! \brief A shared registry with only the built-in codecs. */
+  static const CodecRegistry& defaults();
+
+  void add(std::unique_ptr<Codec> codec);
+
+  const Codec* find(std::string_view name) const;
+  const Codec* detect(std::span<const atUint8> src) const;
+
+  /*! \brief Same as Codec::decodedSize, with the codec picked by detect(). */
+  atUint64 decodedSize(std::span<const atUint8> src) const;
+
+  /*! \brief Same as Codec::decode, with the codec picked by detect(); -1 if no codec matches. */
+  atInt64 decode(std::span<const atUint8> src, atUint8* dst, atUint64 dstLen) const;
+  atInt64 decode(std::span<const atUint8> src, IStreamWriter& writer, atUint64 decodedSize = 0) const;
+
+private:
+  std::vector<std::unique_ptr<Codec>> m_codecs;
+};
+} // namespace athena::io::Compression
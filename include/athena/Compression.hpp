@@ -1,21 +1,127 @@
 #pragma once
 
+#include <memory>
+#include <span>
+#include <vector>
+
 #include "athena/Types.hpp"
 
+#if AT_LZOKAY
+#include <lzokay.hpp>
+#endif
+
+namespace athena::io {
+class IStreamWriter;
+}
+
 namespace athena::io::Compression {
 // Zlib compression
 atInt32 decompressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen);
-atInt32 compressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen);
+// level is 0-9 (or -1 for zlib's default); see ZlibReader / ZlibWriter for streaming
+atInt32 compressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen, atInt32 level = 9);
+#if !defined(GEKKO) && !defined(__SWITCH__)
+// Deflates blockSize pieces of src on threadCount workers (0 = one per core), each primed with the 32 KiB before it,
+// and joins them into one zlib (or gzip) stream. Only built where threads are available (not on GEKKO or NX)
+std::vector<atUint8> compressZlibParallel(const atUint8* src, atUint64 srcLen, atInt32 level = 9,
+                                          atUint32 threadCount = 0, atUint32 blockSize = 0x20000, bool gzip = false);
+#endif
+
+// Guesses from samples of up to 128 KiB how well src compresses, as a rough compressed / original size ratio
+// between 0 and 1. It looks at byte entropy and repeated 4-byte sequences, so it costs far less than a deflate
+float estimateCompressibility(const atUint8* src, atUint64 srcLen);
+// Whether src is likely to compress to at most maxRatio of its size; already compressed or encrypted data isn't.
+// When the estimate says no, a level 1 deflate of a 64 KiB sample confirms it
+bool worthCompressing(const atUint8* src, atUint64 srcLen, float maxRatio = 0.97f);
+// compressZlib if src is worth compressing; returns 0 instead when it isn't, or when the output isn't smaller than src
+atInt32 compressZlibIfWorthwhile(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen, atInt32 level = 9,
+                                 float maxRatio = 0.97f);
 
 #if AT_LZOKAY
 // lzo compression
 atInt32 decompressLZO(const atUint8* source, atInt32 sourceSize, atUint8* dst, atInt32& dstSize);
+// Decodes into writer; returns the decoded size, or a negative lzokay::EResult
+atInt64 decompressLZO(const atUint8* src, atUint32 srcLen, IStreamWriter& writer, atUint32 uncompressedSize);
+// Returns the compressed size, or a negative lzokay::EResult. Each thread reuses one LZOEncoder for this
+atInt32 compressLZO(const atUint8* src, atUint32 srcSize, atUint8* dst, atUint32 dstSize);
+
+/*! \class LZOEncoder
+ *  \brief LZO1X encoder that keeps lzokay's match dictionary between calls
+ *
+ *  The dictionary is over 200 KiB, so compressing many small buffers with one encoder
+ *  saves allocating and releasing it every time. Encoders are not shared between threads.
+ */
+class LZOEncoder {
+public:
+  LZOEncoder();
+  ~LZOEncoder();
+
+  // Same as compressLZO
+  atInt32 encode(const atUint8* src, atUint32 srcSize, atUint8* dst, atUint32 dstSize);
+
+  // Incompressible input grows by up to 1/16th plus a few bytes
+  static constexpr atUint32 maxEncodedSize(atUint32 srcSize) {
+    return atUint32(lzokay::compress_worst_size(srcSize));
+  }
+
+private:
+  struct Dictionary;
+  std::unique_ptr<Dictionary> m_dict;
+};
 #endif
 
 // Yaz0 encoding
 atUint32 yaz0Decode(const atUint8* src, atUint8* dst, atUint32 uncompressedSize);
-atUint32 yaz0Encode(const atUint8* src, atUint32 srcSize, atUint8* data);
+// Bounds-checked decoding; both return the decoded size, or -1 if src is truncated or corrupt
+atInt64 yaz0Decode(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen);
+atInt64 yaz0Decode(const atUint8* src, atUint32 srcLen, IStreamWriter& writer, atUint32 uncompressedSize);
+// level 1-9 trades compression for speed; 9 searches the whole window
+atUint32 yaz0Encode(const atUint8* src, atUint32 srcSize, atUint8* data, atInt32 level = 9);
+
+/*! \class Yaz0Encoder
+ *  \brief Yaz0 encoder that keeps its match tables and look-ahead state to itself
+ *
+ *  One encoder compresses any number of buffers one after another, reusing its tables.
+ *  Separate encoders can run on separate threads at the same time.
+ */
+class Yaz0Encoder {
+public:
+  explicit Yaz0Encoder(atInt32 level = 9);
+  ~Yaz0Encoder();
+
+  // Same output as yaz0Encode; data must hold maxEncodedSize(srcSize) bytes
+  atUint32 encode(const atUint8* src, atUint32 srcSize, atUint8* data);
+
+  // One flag byte per 8 literals in the worst case
+  static constexpr atUint32 maxEncodedSize(atUint32 srcSize) { return srcSize + (srcSize + 7) / 8; }
+
+private:
+  void _reset(const atUint8* src, atUint32 srcSize);
+  atUint32 _find(atInt32 pos, atUint32* pMatchPos);
+  atUint32 _hash(atInt32 pos) const;
+  atUint32 _nintendoEnc(atInt32 pos, atUint32* pMatchPos);
+
+  const atUint8* m_src = nullptr;
+  atInt32 m_size = 0;
+  atUint32 m_maxChain;
+  atInt32 m_inserted = 0;
+  std::unique_ptr<atInt32[]> m_head;
+  std::unique_ptr<atInt32[]> m_prev;
+  atUint32 m_numBytes1 = 0;
+  atUint32 m_matchPos = 0;
+  bool m_prevFlag = false;
+};
+
+#if !defined(GEKKO) && !defined(__SWITCH__)
+// Encodes every input on a pool of threadCount workers (0 = one per core); results come back in input order.
+// Only built where threads are available (not on GEKKO or NX)
+std::vector<std::vector<atUint8>> yaz0EncodeBatch(const std::vector<std::span<const atUint8>>& inputs,
+                                                  atInt32 level = 9, atUint32 threadCount = 0);
+#endif
 
 atUint32 decompressLZ77(const atUint8* src, atUint32 srcLen, atUint8** dst);
+// Decompressed size from an LZ77 header (4 bytes, or 8 for type 0x11 data over 16 MiB)
+atUint32 lz77DecompressedSize(const atUint8* src);
+// Decodes into dst; returns the decompressed size, or 0 if src is corrupt or dst is too small
+atUint32 decompressLZ77Into(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen);
 atUint32 compressLZ77(const atUint8* src, atUint32 srcLen, atUint8** dst, bool extended = false);
 } // namespace athena::io::Compression
@@ -105,6 +105,7 @@ struct DNA {
   using PropCount = athena::io::PropCount<PropType::None>;
   using ReadYaml = athena::io::ReadYaml<PropType::None>;
   using WriteYaml = athena::io::WriteYaml<PropType::None>;
+  using FastRead = athena::io::FastRead;
 };
 
 /**
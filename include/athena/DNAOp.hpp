@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "athena/ChecksumsLiterals.hpp"
+#include "athena/FastReader.hpp"
 #include "athena/IStreamReader.hpp"
 #include "athena/IStreamWriter.hpp"
 #include "athena/YAMLDocReader.hpp"
@@ -340,6 +341,14 @@ struct Read {
   template <class T, class S, Endian DNAE>
   static std::enable_if_t<!std::is_same_v<T, bool>> Do(const PropId& id, std::vector<T>& vector, const S& count,
                                                        StreamT& r) {
+    if constexpr (std::is_arithmetic_v<T>) {
+      /* Plain numbers are read in one go */
+      if constexpr (DNAE == Endian::Big)
+        r.enumerateBig(vector, count);
+      else
+        r.enumerateLittle(vector, count);
+      return;
+    }
     vector.clear();
     vector.reserve(count);
     for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
@@ -357,7 +366,7 @@ struct Read {
       vector.push_back(r.readBool());
   }
   static void Do(const PropId& id, std::unique_ptr<atUint8[]>& buf, size_t count, StreamT& r) {
-    buf.reset(new atUint8[count]);
+    buf = std::make_unique_for_overwrite<atUint8[]>(count);
     r.readUBytesToBuf(buf.get(), count);
   }
   template <class T, Endian DNAE>
@@ -429,6 +438,77 @@ __READ_S(atVec4d, Endian::Little) { var = r.readVec4dLittle(); }
 __READ_WSTR_S(Endian::Little) { str = r.readWStringLittle(); }
 __READ_WSTRC_S(Endian::Little) { str = r.readWStringLittle(count); }
 
+/* Reads from a FastReaderBase; only plain (non-property) records are supported */
+struct FastRead {
+  using PropT = uint32_t;
+  using StreamT = FastReaderBase;
+  template <class T, Endian DNAE>
+  static std::enable_if_t<std::is_enum_v<T>> Do(const PropId& id, T& var, StreamT& r) {
+    using PODType = std::underlying_type_t<T>;
+    FastRead::Do<PODType, DNAE>(id, *reinterpret_cast<PODType*>(&var), r);
+  }
+  template <class T, Endian DNAE>
+  static std::enable_if_t<__IsPODType_v<T>> Do(const PropId& id, T& var, StreamT& r) {
+    using CastT = __CastPODType<T>;
+    static_cast<CastT&>(var) = r.template readValEndian<CastT, DNAE>();
+  }
+  template <class T, Endian DNAE>
+  static std::enable_if_t<__IsDNARecord_v<T>> Do(const PropId& id, T& var, StreamT& r) {
+    var.template Enumerate<FastRead>(r);
+  }
+  template <class T, Endian DNAE>
+  static std::enable_if_t<std::is_array_v<T>> Do(const PropId& id, T& var, StreamT& s) {
+    for (auto& v : var) {
+      FastRead::Do<std::remove_reference_t<decltype(v)>, DNAE>(id, v, s);
+    }
+  }
+  template <class T, Endian DNAE>
+  static void DoSize(const PropId& id, T& var, StreamT& s) {
+    FastRead::Do<T, DNAE>(id, var, s);
+  }
+  template <class T, class S, Endian DNAE>
+  static void Do(const PropId& id, std::vector<T>& vector, const S& count, StreamT& r) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      if constexpr (DNAE == Endian::Big)
+        r.enumerateBig(vector, count);
+      else
+        r.enumerateLittle(vector, count);
+    } else {
+      vector.clear();
+      vector.reserve(count);
+      for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+        if constexpr (std::is_same_v<T, bool>) {
+          vector.push_back(r.readBool());
+        } else {
+          vector.emplace_back();
+          FastRead::Do<T, DNAE>(id, vector.back(), r);
+        }
+      }
+    }
+  }
+  static void Do(const PropId& id, std::unique_ptr<atUint8[]>& buf, size_t count, StreamT& r) {
+    buf = std::make_unique_for_overwrite<atUint8[]>(count);
+    r.readUBytesToBuf(buf.get(), count);
+  }
+  template <class T, Endian DNAE>
+  static std::enable_if_t<std::is_same_v<T, std::string>> Do(const PropId& id, T& str, StreamT& r) {
+    str = r.readString();
+  }
+  static void Do(const PropId& id, std::string& str, atInt32 count, StreamT& r) { str = r.readString(count); }
+  template <class T, Endian DNAE>
+  static std::enable_if_t<std::is_same_v<T, std::wstring>> Do(const PropId& id, T& str, StreamT& r) {
+    str = DNAE == Endian::Big ? r.readWStringBig() : r.readWStringLittle();
+  }
+  template <Endian DNAE>
+  static void Do(const PropId& id, std::wstring& str, atInt32 count, StreamT& r) {
+    str = DNAE == Endian::Big ? r.readWStringBig(count) : r.readWStringLittle(count);
+  }
+  static void DoSeek(atInt64 amount, SeekOrigin whence, StreamT& r) { r.seek(amount, whence); }
+  static void DoAlign(atInt64 amount, StreamT& r) {
+    r.seek((r.position() + amount - 1) / amount * amount, athena::SeekOrigin::Begin);
+  }
+};
+
 template <PropType PropOp>
 struct Write {
   using PropT = std::conditional_t<PropOp == PropType::CRC64, uint64_t, uint32_t>;
@@ -497,6 +577,14 @@ struct Write {
   template <class T, class S, Endian DNAE>
   static std::enable_if_t<!std::is_same_v<T, bool>> Do(const PropId& id, std::vector<T>& vector, const S& count,
                                                        StreamT& w) {
+    if constexpr (std::is_arithmetic_v<T> && PropOp == PropType::None) {
+      /* Plain numbers are written in one go */
+      if constexpr (DNAE == Endian::Big)
+        w.enumerateBig(vector);
+      else
+        w.enumerateLittle(vector);
+      return;
+    }
     for (T& v : vector) {
       Write<PropOp>::template Do<T, DNAE>(id, v, w);
     }
@@ -849,6 +937,11 @@ void __Read(T& obj, athena::io::IStreamReader& r) {
   __Do<Read<PropType::None>, T, T::DNAEndian>({}, obj, r);
 }
 
+template <class T>
+void __FastRead(T& obj, athena::io::FastReaderBase& r) {
+  __Do<FastRead, T, T::DNAEndian>({}, obj, r);
+}
+
 template <class T>
 void __Write(const T& obj, athena::io::IStreamWriter& w) {
   __Do<Write<PropType::None>, T, T::DNAEndian>({}, const_cast<T&>(obj), w);
@@ -963,6 +1056,9 @@ void __BinarySizeProp64(const T& obj, size_t& s) {
   void write(athena::io::IStreamWriter& w) const { athena::io::__Write(*this, w); }                                    \
   void binarySize(size_t& s) const { athena::io::__BinarySize(*this, s); }
 
+#define AT_DECL_FAST_READ                                                                                              \
+  void read(athena::io::FastReaderBase& r) { athena::io::__FastRead(*this, r); }
+
 #define AT_DECL_DNA_YAML                                                                                               \
   AT_DECL_DNA                                                                                                          \
   void read(athena::io::YAMLDocReader& r) { athena::io::__ReadYaml(*this, r); }                                        \
@@ -1022,6 +1118,9 @@ void __BinarySizeProp64(const T& obj, size_t& s) {
   template void __VA_ARGS__::Enumerate<athena::io::BinarySize<athena::io::PropType::None>>(                            \
       athena::io::BinarySize<athena::io::PropType::None>::StreamT & s);
 
+#define AT_SPECIALIZE_DNA_FAST_READ(...)                                                                               \
+  template void __VA_ARGS__::Enumerate<athena::io::FastRead>(athena::io::FastRead::StreamT & s);
+
 #define AT_SPECIALIZE_DNA_YAML(...)                                                                                    \
   AT_SPECIALIZE_DNA(__VA_ARGS__)                                                                                       \
   template void __VA_ARGS__::Enumerate<athena::io::ReadYaml<athena::io::PropType::None>>(                              \
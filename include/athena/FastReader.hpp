@@ -0,0 +1,323 @@
+#pragma once
+
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "athena/Global.hpp"
+#include "athena/Utility.hpp"
+
+namespace athena::io {
+/*! \class FastReaderBase
+ *  \brief A non-virtual reader over a block of memory
+ *
+ *  Unlike IStreamReader, nothing here goes through a virtual call, and every
+ *  value read names its endianness at compile time, so a field read compiles
+ *  down to a bounds check, a load and (if needed) a byte swap.
+ *  The memory is only referenced and must outlive the reader.
+ *
+ *  DNA records that add AT_DECL_FAST_READ can be read from it with the FastRead op.
+ *  Every DNA record nested in such a record, as a member or a Vector element, has to
+ *  declare AT_DECL_FAST_READ too; atdna only emits the FastRead Enumerate for records
+ *  that opt in, so a missing one shows up as an undefined symbol at link time.
+ *  \sa FastReader
+ */
+class FastReaderBase {
+public:
+  /*! \brief This constructor references an existing buffer to read from.
+   *
+   *   \param data      The existing buffer.
+   *   \param length    The length of the existing buffer.
+   *   \param globalErr Whether or not global errors are enabled.
+   */
+  FastReaderBase(const void* data, atUint64 length, bool globalErr = true)
+  : m_data(static_cast<const atUint8*>(data)), m_length(length), m_globalErr(globalErr) {}
+  explicit FastReaderBase(std::span<const atUint8> data, bool globalErr = true)
+  : FastReaderBase(data.data(), data.size(), globalErr) {}
+
+  /*! \brief Sets the position relative to the specified origin.
+   *         It seeks relative to the current position by default.
+   */
+  void seek(atInt64 position, SeekOrigin origin = SeekOrigin::Current) {
+    atInt64 target = position;
+    if (origin == SeekOrigin::Current)
+      target = atInt64(m_position) + position;
+    else if (origin == SeekOrigin::End)
+      target = atInt64(m_length) - position;
+
+    if (target < 0 || atUint64(target) > m_length) [[unlikely]] {
+      if (m_globalErr)
+        atError(FMT_STRING("Position {:08X} outside stream bounds "), target);
+      m_position = target < 0 ? 0 : m_length;
+      setError();
+      return;
+    }
+
+    m_position = atUint64(target);
+  }
+
+  void seekAlign64() { seek(ROUND_UP_64(m_position), SeekOrigin::Begin); }
+  void seekAlign32() { seek(ROUND_UP_32(m_position), SeekOrigin::Begin); }
+  void seekAlign16() { seek(ROUND_UP_16(m_position), SeekOrigin::Begin); }
+  void seekAlign4() { seek(ROUND_UP_4(m_position), SeekOrigin::Begin); }
+
+  atUint64 position() const { return m_position; }
+  atUint64 length() const { return m_length; }
+  bool atEnd() const { return m_position >= m_length; }
+  bool hasError() const { return m_hasError; }
+  void setError() { m_hasError = true; }
+
+  /*! \brief Returns the whole buffer being read. */
+  std::span<const atUint8> span() const { return {m_data, size_t(m_length)}; }
+
+  /*! \brief Reads up to len bytes to a user-allocated buffer.
+   *
+   *  \return The number of bytes actually read
+   */
+  atUint64 readUBytesToBuf(void* buf, atUint64 len) {
+    if (len > m_length - m_position) [[unlikely]] {
+      _outOfBounds();
+      len = m_length - m_position;
+      m_position = m_length;
+      memcpy(buf, m_data + m_length - len, len);
+      return len;
+    }
+    memcpy(buf, m_data + m_position, len);
+    m_position += len;
+    return len;
+  }
+
+  /*! \brief Returns the next len bytes without advancing. */
+  std::span<const atUint8> peek(atUint64 len) const {
+    return {m_data + m_position, size_t(std::min(len, m_length - m_position))};
+  }
+
+  /*! \brief Returns the next len bytes and advances past them. */
+  std::span<const atUint8> readSpan(atUint64 len) {
+    if (len > m_length - m_position) [[unlikely]] {
+      _outOfBounds();
+      len = m_length - m_position;
+    }
+    std::span<const atUint8> ret{m_data + m_position, size_t(len)};
+    m_position += len;
+    return ret;
+  }
+
+  atInt8 readByte() { return _readVal<atInt8, Endian::Little>(); }
+  atUint8 readUByte() { return _readVal<atUint8, Endian::Little>(); }
+  bool readBool() { return _readVal<bool, Endian::Little>(); }
+
+  template <class T>
+  T readValBig() {
+    return _readVal<T, Endian::Big>();
+  }
+  template <class T>
+  T readValLittle() {
+    return _readVal<T, Endian::Little>();
+  }
+  template <class T, Endian E>
+  T readValEndian() {
+    return _readVal<T, E>();
+  }
+
+  /*! \brief Reads a string and advances the position
+   *
+   *  \param fixedLen If non-negative, this is a fixed-length string read.
+   *  \param doSeek   Whether or not to skip the rest of a fixed-length field after its terminator.
+   */
+  std::string readString(atInt32 fixedLen = -1, bool doSeek = true) {
+    if (fixedLen == 0)
+      return {};
+    const atUint64 avail = fixedLen > 0 ? std::min(atUint64(fixedLen), m_length - m_position) : m_length - m_position;
+    const auto* start = reinterpret_cast<const char*>(m_data + m_position);
+    const auto* end = static_cast<const char*>(memchr(start, 0, avail));
+    const atUint64 len = end ? atUint64(end - start) : avail;
+    std::string ret(start, len);
+
+    if (fixedLen > 0 && doSeek)
+      m_position += avail;
+    else
+      m_position += std::min(len + 1, avail);
+    if (!end && (fixedLen < 0 || avail < atUint64(fixedLen)))
+      _outOfBounds();
+    return ret;
+  }
+
+  std::wstring readWStringBig(atInt32 fixedLen = -1, bool doSeek = true) {
+    return _readWString<Endian::Big>(fixedLen, doSeek);
+  }
+  std::wstring readWStringLittle(atInt32 fixedLen = -1, bool doSeek = true) {
+    return _readWString<Endian::Little>(fixedLen, doSeek);
+  }
+
+  template <class T>
+  void enumerateBig(std::vector<T>& vector, size_t count) {
+    _enumerate<T, Endian::Big>(vector, count);
+  }
+  template <class T>
+  void enumerateLittle(std::vector<T>& vector, size_t count) {
+    _enumerate<T, Endian::Little>(vector, count);
+  }
+
+  /*! \brief Performs lambda-assisted std::vector enumeration reads using type T
+   *
+   *  \param readf Function that reads *one* element and assigns it through the second argument
+   */
+  template <class T>
+  void enumerate(std::vector<T>& vector, size_t count, std::function<void(FastReaderBase&, T&)> readf) {
+    vector.clear();
+    vector.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      vector.emplace_back();
+      readf(*this, vector.back());
+    }
+  }
+
+protected:
+  template <class T>
+  static constexpr bool _IsVecType =
+      std::is_same_v<T, atVec2f> || std::is_same_v<T, atVec3f> || std::is_same_v<T, atVec4f> ||
+      std::is_same_v<T, atVec2d> || std::is_same_v<T, atVec3d> || std::is_same_v<T, atVec4d>;
+
+  template <Endian E, class T>
+  static T _swap(T val) {
+    if constexpr (sizeof(T) == 1 || E == utility::SystemEndian)
+      return val;
+    else if constexpr (sizeof(T) == 2)
+      return std::bit_cast<T>(utility::swapU16(std::bit_cast<atUint16>(val)));
+    else if constexpr (sizeof(T) == 4)
+      return std::bit_cast<T>(utility::swapU32(std::bit_cast<atUint32>(val)));
+    else
+      return std::bit_cast<T>(utility::swapU64(std::bit_cast<atUint64>(val)));
+  }
+
+  template <class T, Endian E>
+  T _readVal() {
+    if constexpr (std::is_same_v<T, bool>) {
+      return _readVal<atUint8, E>() != 0;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+      if (sizeof(T) > m_length - m_position) [[unlikely]] {
+        _outOfBounds();
+        m_position = m_length;
+        return T();
+      }
+      T val;
+      memcpy(&val, m_data + m_position, sizeof(T));
+      m_position += sizeof(T);
+      return _swap<E>(val);
+    } else if constexpr (_IsVecType<T>) {
+      using ElemT = std::conditional_t<
+          std::is_same_v<T, atVec2f> || std::is_same_v<T, atVec3f> || std::is_same_v<T, atVec4f>, float, double>;
+      constexpr size_t Count = std::is_same_v<T, atVec2f> || std::is_same_v<T, atVec2d>   ? 2
+                               : std::is_same_v<T, atVec3f> || std::is_same_v<T, atVec3d> ? 3
+                                                                                          : 4;
+      std::conditional_t<std::is_same_v<ElemT, float>, simd_floats, simd_doubles> val = {};
+      for (size_t i = 0; i < Count; ++i)
+        val[i] = _readVal<ElemT, E>();
+      T s;
+      s.simd.copy_from(val);
+      return s;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+      return readString();
+    } else if constexpr (std::is_same_v<T, std::wstring>) {
+      return _readWString<E>(-1, true);
+    } else {
+      static_assert(!sizeof(T), "unsupported FastReader value type");
+    }
+  }
+
+  template <Endian E>
+  std::wstring _readWString(atInt32 fixedLen, bool doSeek) {
+    if (fixedLen == 0)
+      return {};
+    std::wstring ret;
+    atUint16 chr = _readVal<atUint16, E>();
+
+    atInt32 i;
+    for (i = 1; chr != 0 && !m_hasError; ++i) {
+      ret += chr;
+
+      if (fixedLen > 0 && i >= fixedLen)
+        break;
+
+      chr = _readVal<atUint16, E>();
+    }
+
+    // Skips the same distance IStreamReader does, so both leave the stream at the same place
+    if (doSeek && fixedLen > 0 && i < fixedLen)
+      seek(fixedLen - i);
+
+    return ret;
+  }
+
+  template <class T, Endian E>
+  void _enumerate(std::vector<T>& vector, size_t count) {
+    vector.clear();
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      // Plain numbers are copied in one go and swapped in place
+      if (atUint64(count) > (m_length - m_position) / sizeof(T)) [[unlikely]] {
+        _outOfBounds();
+        m_position = m_length;
+        return;
+      }
+      vector.resize(count);
+      memcpy(vector.data(), m_data + m_position, count * sizeof(T));
+      m_position += count * sizeof(T);
+      if constexpr (E != utility::SystemEndian)
+        utility::swapArray(vector.data(), count);
+    } else {
+      vector.reserve(count);
+      for (size_t i = 0; i < count; ++i)
+        vector.push_back(_readVal<T, E>());
+    }
+  }
+
+  void _outOfBounds() {
+    if (m_globalErr)
+      atError(FMT_STRING("Position {:08X} outside stream bounds "), m_position);
+    setError();
+  }
+
+  const atUint8* m_data;
+  atUint64 m_length;
+  atUint64 m_position = 0;
+  bool m_hasError = false;
+  bool m_globalErr;
+};
+
+/*! \class FastReader
+ *  \brief FastReaderBase with its endianness fixed at compile time
+ *
+ *  readVal / enumerate / readWString use Endian E, so formats with a single byte
+ *  order can be parsed without spelling it out on every call.
+ */
+template <Endian E>
+class FastReader : public FastReaderBase {
+public:
+  using FastReaderBase::FastReaderBase;
+
+  static constexpr Endian endian() { return E; }
+
+  template <class T>
+  T readVal() {
+    return _readVal<T, E>();
+  }
+
+  template <class T>
+  void enumerate(std::vector<T>& vector, size_t count) {
+    _enumerate<T, E>(vector, count);
+  }
+  using FastReaderBase::enumerate;
+
+  std::wstring readWString(atInt32 fixedLen = -1, bool doSeek = true) { return _readWString<E>(fixedLen, doSeek); }
+};
+template <Endian E, typename T>
+FastReader<E>& operator>>(FastReader<E>& lhs, T& rhs) {
+  rhs = lhs.template readVal<T>();
+  return lhs;
+}
+} // namespace athena::io
@@ -11,6 +11,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "athena/IStreamReader.hpp"
 #include "athena/Types.hpp"
@@ -38,8 +39,8 @@ public:
 #endif
   }
 
-  void open();
-  void close();
+  virtual void open();
+  virtual void close();
   bool isOpen() const { return m_fileHandle != 0; }
   bool save();
   void seek(atInt64 pos, SeekOrigin origin = SeekOrigin::Current) override;
@@ -47,7 +48,21 @@ public:
   atUint64 length() const override;
   atUint64 readUBytesToBuf(void* buf, atUint64 len) override;
 
-  void setCacheSize(const atInt32 blockSize);
+  /*! \brief Sets up the read cache.
+   *
+   *  Reads are served from up to blockCount blocks of blockSize bytes each, evicting the least
+   *  recently used block when a new one is needed. A blockSize of 0 disables caching.
+   *
+   *   \param blockSize  Size of each cache block in bytes
+   *   \param blockCount Number of blocks to keep resident
+   */
+  virtual void setCacheSize(atInt32 blockSize, atUint32 blockCount = 1);
+
+  /*! \brief Re-reads the file size from the open handle and drops all cached blocks.
+   *
+   *  The size is only queried once on open(); call this if the file may have been changed by someone else.
+   */
+  virtual void refreshLength();
 
 #if _WIN32
   using HandleType = HANDLE;
@@ -58,16 +73,37 @@ public:
   HandleType _fileHandle() { return m_fileHandle; }
 
 protected:
+  struct CacheBlock {
+    std::unique_ptr<atUint8[]> data;
+    atInt64 index = -1;
+    atUint64 size = 0;
+    atUint64 capacity = 0;
+    atUint64 lastUse = 0;
+  };
+
+  /* Reads at an absolute offset, only seeking the handle when it isn't already there */
+  atUint64 _readAt(atUint64 offset, void* buf, atUint64 len);
+  /* Platform specific part of _readAt; returns false if the handle couldn't be moved, without reporting it */
+  bool _rawReadAt(atUint64 offset, void* buf, atUint64 len, atUint64& got);
+  atUint64 _queryLength() const;
+
+  std::span<const atUint8> _contiguousSpan(atUint64 length) override;
+
+  const CacheBlock* _fetchBlock(atInt64 index);
+  void _invalidateCache();
+
 #if _WIN32
   std::wstring m_filename;
 #else
   std::string m_filename;
 #endif
   HandleType m_fileHandle;
-  std::unique_ptr<atUint8[]> m_cacheData;
-  atInt32 m_blockSize;
-  atInt32 m_curBlock;
-  atUint64 m_offset;
+  std::vector<CacheBlock> m_cache;
+  atUint64 m_blockSize = 0;
+  atUint64 m_offset = 0;
+  atUint64 m_rawOffset = 0;
+  atUint64 m_fileSize = 0;
+  atUint64 m_useCounter = 0;
   bool m_globalErr;
 };
 } // namespace athena::io
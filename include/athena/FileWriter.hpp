@@ -9,6 +9,8 @@
 #include <cstdio>
 #endif
 
+#include <memory>
+
 #include "athena/IStreamWriter.hpp"
 #include "athena/Types.hpp"
 
@@ -36,12 +38,34 @@ public:
 
   void open(bool overwrite = true);
   void close();
+
+  /*! \brief Closes the file without committing it.
+   *
+   *  In overwrite mode the temporary file is deleted and the target is left untouched.
+   *  Otherwise the data already written in place stays, minus anything still buffered.
+   */
+  void discard();
   bool isOpen() const { return m_fileHandle != nullptr; }
   void seek(atInt64 pos, SeekOrigin origin = SeekOrigin::Current) override;
-  atUint64 position() const override;
-  atUint64 length() const override;
+  atUint64 position() const override { return m_position; }
+  atUint64 length() const override { return m_length; }
   void writeUBytes(const atUint8* data, atUint64 len) override;
 
+  /*! \brief Writes the slices back to back; large batches go out in a single writev together with the buffer. */
+  void writeUBytesV(const atIoSlice* slices, size_t count) override;
+
+  /*! \brief Writes out any buffered data. */
+  void flush();
+
+  /*! \brief Sets the size of the write buffer, flushing what is currently buffered.
+   *
+   *  Writes are collected in the buffer until it fills up or the position moves
+   *  outside of it, so many small writes become a single one. A size of 0 disables buffering.
+   *
+   *   \param size Size of the write buffer in bytes
+   */
+  void setBufferSize(atUint64 size);
+
 #ifdef _WIN32
   using HandleType = HANDLE;
 #else
@@ -51,12 +75,24 @@ public:
   HandleType _fileHandle() { return m_fileHandle; }
 
 private:
+  /* Platform specific; writes the slices back to back at an absolute offset */
+  bool _writeAt(atUint64 offset, const atIoSlice* slices, size_t count);
+  atUint64 _queryLength() const;
+
 #ifdef _WIN32
   std::wstring m_filename;
 #else
   std::string m_filename;
 #endif
   HandleType m_fileHandle;
+  std::unique_ptr<atUint8[]> m_buffer;
+  atUint64 m_bufferSize = 64 * 1024;
+  atUint64 m_bufferOffset = 0; // file offset of m_buffer[0]
+  atUint64 m_bufferLength = 0;
+  atUint64 m_position = 0;
+  atUint64 m_length = 0;
+  atUint64 m_rawOffset = 0;
+  bool m_overwrite = true;
   bool m_globalErr;
 };
 
@@ -69,6 +105,27 @@ class TransactionalFileWriter : public IStreamWriter {
   bool m_overwrite, m_globalErr;
   std::vector<uint8_t> m_deferredBuffer;
   atUint64 m_position = 0;
+  atUint64 m_spillThreshold = 0;
+  std::unique_ptr<FileWriter> m_spill;
+
+  void _spill();
+
+  // Renames w's file into place, unless a write to it failed; then the target is left as it was
+  void _commit(FileWriter& w) {
+    if (!w.isOpen()) {
+      setError();
+      return;
+    }
+    w.flush();
+    if (w.hasError()) {
+      w.discard();
+      setError();
+      return;
+    }
+    w.close();
+    if (w.hasError())
+      setError();
+  }
 
 public:
   explicit TransactionalFileWriter(std::string_view filename, bool overwrite = true, bool globalErr = true)
@@ -88,21 +145,38 @@ public:
 #endif
   }
 
+  /*! \brief Lets the output move from memory to the temporary file once it grows past threshold bytes.
+   *
+   *  From then on data is streamed to the same "~" file that flush() would have written, and
+   *  flush() only has to rename it into place; cancel() deletes it. Only applies in overwrite
+   *  mode. 0, the default, keeps everything in memory until flush().
+   */
+  void setSpillThreshold(atUint64 threshold) { m_spillThreshold = threshold; }
+
   void flush() {
-    if (m_deferredBuffer.size()) {
+    if (m_spill) {
+      _commit(*m_spill);
+      m_spill.reset();
+      cancel();
+    } else if (m_deferredBuffer.size()) {
       FileWriter w(m_filename, m_overwrite, m_globalErr);
       w.writeUBytes(m_deferredBuffer.data(), m_deferredBuffer.size());
+      _commit(w);
       cancel();
     }
   }
 
   void cancel() {
+    if (m_spill) {
+      m_spill->discard();
+      m_spill.reset();
+    }
     m_deferredBuffer.clear();
     m_position = 0;
   }
 
-  atUint64 position() const override { return m_position; }
-  atUint64 length() const override { return m_deferredBuffer.size(); }
+  atUint64 position() const override { return m_spill ? m_spill->position() : m_position; }
+  atUint64 length() const override { return m_spill ? m_spill->length() : m_deferredBuffer.size(); }
   void seek(atInt64 pos, SeekOrigin origin = SeekOrigin::Current) override;
   void writeUBytes(const atUint8* data, atUint64 len) override;
 
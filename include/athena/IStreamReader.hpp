@@ -1,10 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <memory>
+#include <span>
 #include <type_traits>
 #include <vector>
 
+#include "athena/BufferPool.hpp"
 #include "athena/IStream.hpp"
 #include "athena/Utility.hpp"
 
@@ -105,8 +109,10 @@ public:
    * @return The buffer at the current position from the given length.
    */
   std::unique_ptr<atInt8[]> readBytes(atUint64 length) {
-    auto buf = std::make_unique<atInt8[]>(length);
-    readUBytesToBuf(buf.get(), length);
+    auto buf = std::make_unique_for_overwrite<atInt8[]>(length);
+    // The buffer starts out uninitialized; don't hand back garbage past a short read
+    const atUint64 got = readUBytesToBuf(buf.get(), length);
+    std::memset(buf.get() + got, 0, length - got);
     return buf;
   }
 
@@ -115,11 +121,70 @@ public:
    *  @return The buffer at the current position from the given length.
    */
   std::unique_ptr<atUint8[]> readUBytes(atUint64 length) {
-    auto buf = std::make_unique<atUint8[]>(length);
-    readUBytesToBuf(buf.get(), length);
+    auto buf = std::make_unique_for_overwrite<atUint8[]>(length);
+    const atUint64 got = readUBytesToBuf(buf.get(), length);
+    std::memset(buf.get() + got, 0, length - got);
     return buf;
   }
 
+  /** @brief Like readUBytes, but takes the buffer from the calling thread's BufferPool.
+   *
+   *  Freeing the result hands the memory back to the pool, so decode loops that read and drop
+   *  a payload per iteration stop going to the heap after the first few rounds.
+   *
+   *  @return The buffer at the current position from the given length.
+   */
+  BufferPool::Buffer readUBytesPooled(atUint64 length) {
+    auto buf = BufferPool::local().acquire(length);
+    const atUint64 got = readUBytesToBuf(buf.get(), length);
+    std::memset(buf.get() + got, 0, length - got);
+    return buf;
+  }
+
+  /** @brief Returns the next bytes in the stream without advancing the current position.
+   *
+   *  Readers backed by memory return a view straight into it; others read into an internal scratch buffer.
+   *  Either way the view is only valid until the next read, seek or peek.
+   *
+   *  @param length Number of bytes to look at
+   *  @return View of the bytes; shorter than length if the stream ends first
+   */
+  std::span<const atUint8> peek(atUint64 length) {
+    length = _clampToEnd(length);
+    if (length == 0)
+      return {};
+
+    std::span<const atUint8> view = _contiguousSpan(length);
+    if (view.size() == length)
+      return view;
+
+    view = _readToScratch(length);
+    if (!view.empty())
+      seek(-atInt64(view.size()), SeekOrigin::Current);
+    return view;
+  }
+
+  /** @brief Reads bytes at the current position and advances the current position, without copying when possible.
+   *
+   *  Same as peek(), except that the position moves past the returned bytes.
+   *
+   *  @param length Number of bytes to read
+   *  @return View of the bytes; shorter than length if the stream ends first
+   */
+  std::span<const atUint8> readSpan(atUint64 length) {
+    length = _clampToEnd(length);
+    if (length == 0)
+      return {};
+
+    std::span<const atUint8> view = _contiguousSpan(length);
+    if (view.size() == length) {
+      seek(atInt64(length), SeekOrigin::Current);
+      return view;
+    }
+
+    return _readToScratch(length);
+  }
+
   /** @brief Attempts to read a fixed length of data into a pre-allocated buffer.
    *  @param buf The buffer to read into
    *  @param len The length of the buffer
@@ -928,25 +993,7 @@ public:
    *  @return The read string
    */
   std::string readString(atInt32 fixedLen = -1, bool doSeek = true) {
-    if (fixedLen == 0)
-      return std::string();
-    std::string ret;
-    atUint8 chr = readByte();
-
-    atInt32 i;
-    for (i = 1; chr != 0; ++i) {
-      ret += chr;
-
-      if (fixedLen > 0 && i >= fixedLen)
-        break;
-
-      chr = readByte();
-    }
-
-    if (doSeek && fixedLen > 0 && i < fixedLen)
-      seek(fixedLen - i);
-
-    return ret;
+    return _readStringChunked<std::string, atUint8>(fixedLen, doSeek, m_endian);
   }
   template <class T>
   std::string readVal(std::enable_if_t<std::is_same_v<T, std::string>>* = nullptr) {
@@ -962,26 +1009,7 @@ public:
    *  @return The read wstring
    */
   std::wstring readWString(atInt32 fixedLen = -1, bool doSeek = true) {
-    if (fixedLen == 0)
-      return std::wstring();
-
-    std::wstring ret;
-    atUint16 chr = readUint16();
-
-    atInt32 i;
-    for (i = 1; chr != 0; ++i) {
-      ret += chr;
-
-      if (fixedLen > 0 && i >= fixedLen)
-        break;
-
-      chr = readUint16();
-    }
-
-    if (doSeek && fixedLen > 0 && i < fixedLen)
-      seek(fixedLen - i);
-
-    return ret;
+    return _readStringChunked<std::wstring, atUint16>(fixedLen, doSeek, m_endian);
   }
   template <class T>
   std::wstring readVal(std::enable_if_t<std::is_same_v<T, std::wstring>>* = nullptr) {
@@ -998,26 +1026,7 @@ public:
    *  @return The read wstring
    */
   std::wstring readWStringLittle(atInt32 fixedLen = -1, bool doSeek = true) {
-    if (fixedLen == 0)
-      return std::wstring();
-
-    std::wstring ret;
-    atUint16 chr = readUint16Little();
-
-    atInt32 i;
-    for (i = 1; chr != 0; ++i) {
-      ret += chr;
-
-      if (fixedLen > 0 && i >= fixedLen)
-        break;
-
-      chr = readUint16Little();
-    }
-
-    if (doSeek && fixedLen > 0 && i < fixedLen)
-      seek(fixedLen - i);
-
-    return ret;
+    return _readStringChunked<std::wstring, atUint16>(fixedLen, doSeek, Endian::Little);
   }
   template <class T>
   std::wstring readValLittle(std::enable_if_t<std::is_same_v<T, std::wstring>>* = nullptr) {
@@ -1034,25 +1043,7 @@ public:
    *  @return The read wstring
    */
   std::wstring readWStringBig(atInt32 fixedLen = -1, bool doSeek = true) {
-    if (fixedLen == 0)
-      return std::wstring();
-    std::wstring ret;
-    atUint16 chr = readUint16Big();
-
-    atInt32 i;
-    for (i = 1; chr != 0; ++i) {
-      ret += chr;
-
-      if (fixedLen > 0 && i >= fixedLen)
-        break;
-
-      chr = readUint16Big();
-    }
-
-    if (doSeek && fixedLen > 0 && i < fixedLen)
-      seek(fixedLen - i);
-
-    return ret;
+    return _readStringChunked<std::wstring, atUint16>(fixedLen, doSeek, Endian::Big);
   }
   template <class T>
   std::wstring readValBig(std::enable_if_t<std::is_same_v<T, std::wstring>>* = nullptr) {
@@ -1069,25 +1060,7 @@ public:
    *  @return The read wstring
    */
   std::u16string readU16StringBig(atInt32 fixedLen = -1, bool doSeek = true) {
-    if (fixedLen == 0)
-      return std::u16string();
-    std::u16string ret;
-    char16_t chr = readUint16Big();
-
-    atInt32 i;
-    for (i = 1; chr != 0; ++i) {
-      ret += chr;
-
-      if (fixedLen > 0 && i >= fixedLen)
-        break;
-
-      chr = readUint16Big();
-    }
-
-    if (doSeek && fixedLen > 0 && i < fixedLen)
-      seek(fixedLen - i);
-
-    return ret;
+    return _readStringChunked<std::u16string, atUint16>(fixedLen, doSeek, Endian::Big);
   }
   template <class T>
   std::u16string readValBig(std::enable_if_t<std::is_same_v<T, std::u16string>>* = nullptr) {
@@ -1104,25 +1077,7 @@ public:
    *  @return The read wstring
    */
   std::u32string readU32StringBig(atInt32 fixedLen = -1, bool doSeek = true) {
-    if (fixedLen == 0)
-      return std::u32string();
-    std::u32string ret;
-    char32_t chr = readUint32Big();
-
-    atInt32 i;
-    for (i = 1; chr != 0; ++i) {
-      ret += chr;
-
-      if (fixedLen > 0 && i >= fixedLen)
-        break;
-
-      chr = readUint32Big();
-    }
-
-    if (doSeek && fixedLen > 0 && i < fixedLen)
-      seek(fixedLen - i);
-
-    return ret;
+    return _readStringChunked<std::u32string, atUint32>(fixedLen, doSeek, Endian::Big);
   }
   template <class T>
   std::u32string readValBig(std::enable_if_t<std::is_same_v<T, std::u32string>>* = nullptr) {
@@ -1140,6 +1095,10 @@ public:
   void enumerate(std::vector<T>& vector, size_t count,
                  std::enable_if_t<std::is_arithmetic_v<T> || std::is_same_v<T, atVec2f> || std::is_same_v<T, atVec3f> ||
                                   std::is_same_v<T, atVec4f>>* = nullptr) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      _enumerateBulk(vector, count, m_endian);
+      return;
+    }
     vector.clear();
     vector.reserve(count);
     for (size_t i = 0; i < count; ++i)
@@ -1157,6 +1116,10 @@ public:
   void enumerateLittle(std::vector<T>& vector, size_t count,
                        std::enable_if_t<std::is_arithmetic_v<T> || std::is_same_v<T, atVec2f> ||
                                         std::is_same_v<T, atVec3f> || std::is_same_v<T, atVec4f>>* = nullptr) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      _enumerateBulk(vector, count, Endian::Little);
+      return;
+    }
     vector.clear();
     vector.reserve(count);
     for (size_t i = 0; i < count; ++i)
@@ -1174,6 +1137,10 @@ public:
   void enumerateBig(std::vector<T>& vector, size_t count,
                     std::enable_if_t<std::is_arithmetic_v<T> || std::is_same_v<T, atVec2f> ||
                                      std::is_same_v<T, atVec3f> || std::is_same_v<T, atVec4f>>* = nullptr) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      _enumerateBulk(vector, count, Endian::Big);
+      return;
+    }
     vector.clear();
     vector.reserve(count);
     for (size_t i = 0; i < count; ++i)
@@ -1213,6 +1180,132 @@ public:
       readf(*this, vector.back());
     }
   }
+
+protected:
+  /*! \brief Returns a view of up to length buffered bytes at the current position,
+   *         or an empty span if the reader has no contiguous storage to offer.
+   */
+  virtual std::span<const atUint8> _contiguousSpan(atUint64 /*length*/) { return {}; }
+
+private:
+  /* Reads the whole array in one call and swaps it in place */
+  template <class T>
+  void _enumerateBulk(std::vector<T>& vector, size_t count, Endian endian) {
+    vector.clear();
+    if (count == 0)
+      return;
+    vector.resize(count);
+    readUBytesToBuf(vector.data(), atUint64(count) * sizeof(T));
+    if (endian != utility::SystemEndian)
+      utility::swapArray(vector.data(), count);
+  }
+
+  /* Reads a string of UnitT code units, scanning whole chunks of buffered data for the terminator.
+   * Consumes and skips exactly as many bytes as reading one unit at a time would */
+  template <class StrT, class UnitT>
+  StrT _readStringChunked(atInt32 fixedLen, bool doSeek, Endian endian) {
+    constexpr atUint64 ChunkSize = 256;
+    if (fixedLen == 0)
+      return StrT();
+
+    StrT ret;
+    const bool swap = sizeof(UnitT) > 1 && endian != utility::SystemEndian;
+    atInt32 i = 0;
+    while (fixedLen < 0 || i < fixedLen) {
+      const atUint64 want = fixedLen > 0 ? atUint64(fixedLen - i) : ChunkSize / sizeof(UnitT);
+      std::span<const atUint8> view = _contiguousSpan(want * sizeof(UnitT));
+      if (view.size() < sizeof(UnitT)) {
+        const atUint64 pos = position();
+        const atUint64 len = length();
+        const atUint64 avail = pos < len ? (len - pos) / sizeof(UnitT) : 0;
+        if (avail)
+          view = peek(std::min({want, avail, ChunkSize / sizeof(UnitT)}) * sizeof(UnitT));
+      }
+
+      const atUint64 units = view.size() / sizeof(UnitT);
+      if (units == 0) {
+        // Nothing left to scan; a plain read reports the error and ends the string
+        UnitT chr = 0;
+        readUBytesToBuf(&chr, sizeof(UnitT));
+        ++i;
+        if (chr == 0)
+          break;
+        if (swap)
+          chr = _swapUnit(chr);
+        ret += typename StrT::value_type(chr);
+        continue;
+      }
+
+      atUint64 n;
+      if constexpr (sizeof(UnitT) == 1) {
+        const void* z = memchr(view.data(), 0, units);
+        n = z ? atUint64(static_cast<const atUint8*>(z) - view.data()) : units;
+      } else if constexpr (sizeof(UnitT) == 2) {
+        n = utility::findZero16(view.data(), units);
+      } else {
+        n = utility::findZero32(view.data(), units);
+      }
+      _appendUnits<StrT, UnitT>(ret, view.data(), n, swap);
+
+      const atUint64 consumed = n < units ? n + 1 : n;
+      seek(atInt64(consumed * sizeof(UnitT)), SeekOrigin::Current);
+      i += atInt32(consumed);
+      if (n < units)
+        break;
+    }
+
+    if (doSeek && fixedLen > 0 && i < fixedLen)
+      seek(fixedLen - i);
+
+    return ret;
+  }
+
+  template <class StrT, class UnitT>
+  static void _appendUnits(StrT& ret, const atUint8* src, atUint64 count, bool swap) {
+    if constexpr (sizeof(typename StrT::value_type) == sizeof(UnitT)) {
+      const size_t old = ret.size();
+      ret.resize(old + count);
+      if (swap && sizeof(UnitT) == 2)
+        utility::swapCopy16(ret.data() + old, src, count);
+      else if (swap && sizeof(UnitT) == 4)
+        utility::swapCopy32(ret.data() + old, src, count);
+      else
+        memcpy(ret.data() + old, src, count * sizeof(UnitT));
+    } else {
+      ret.reserve(ret.size() + count);
+      for (atUint64 j = 0; j < count; ++j) {
+        UnitT chr;
+        memcpy(&chr, src + j * sizeof(UnitT), sizeof(UnitT));
+        ret += typename StrT::value_type(swap ? _swapUnit(chr) : chr);
+      }
+    }
+  }
+
+  template <class UnitT>
+  static UnitT _swapUnit(UnitT chr) {
+    if constexpr (sizeof(UnitT) == 2)
+      return utility::swapU16(chr);
+    else if constexpr (sizeof(UnitT) == 4)
+      return utility::swapU32(chr);
+    else
+      return chr;
+  }
+
+  /* Nothing past the end is asked for, so a view cut short by the end of the stream is already complete
+     and no read is attempted at the end itself, where some readers raise an error */
+  atUint64 _clampToEnd(atUint64 length) const {
+    const atUint64 pos = position();
+    const atUint64 end = this->length();
+    return pos < end ? std::min(length, end - pos) : 0;
+  }
+
+  std::span<const atUint8> _readToScratch(atUint64 length) {
+    if (m_scratch.size() < length)
+      m_scratch.resize(length);
+    return {m_scratch.data(), size_t(readUBytesToBuf(m_scratch.data(), length))};
+  }
+
+  std::vector<atUint8> m_scratch;
 };
 template <typename T>
 IStreamReader& operator>>(IStreamReader& lhs, T& rhs) {
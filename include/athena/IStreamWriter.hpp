@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -31,8 +32,7 @@ public:
     atInt64 delta = pos - position();
     if (delta <= 0)
       return;
-    for (atInt64 i = 0; i < delta; ++i)
-      writeUByte(0);
+    fill(atUint8(0), atUint64(delta));
   }
 
   /** @brief Returns whether or not the stream is at the end.
@@ -77,6 +77,17 @@ public:
    */
   virtual void writeUBytes(const atUint8* data, atUint64 length) = 0;
 
+  /** @brief Writes several buffers back to back, as if by one writeUBytes call each.
+   *  Writers that can hand the whole list to the OS at once override this.
+   *
+   *  @param slices The buffers to write
+   *  @param count The number of buffers
+   */
+  virtual void writeUBytesV(const atIoSlice* slices, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+      writeUBytes(slices[i].data, slices[i].length);
+  }
+
   /** @brief Writes the given buffer with the specified length, buffers can be bigger than the length
    *  however it's undefined behavior to try and write a buffer which is smaller than the given length.
    *
@@ -798,23 +809,17 @@ public:
       return;
 
     if (fixedLen < 0) {
-      for (atUint8 c : str) {
-        writeUByte(c);
-
-        if (c == '\0')
-          break;
-      }
+      // Up to and including an embedded terminator, followed by a terminator either way
+      const size_t nul = str.find('\0');
+      const atUint64 len = nul == std::string_view::npos ? str.size() : nul + 1;
+      if (len)
+        writeUBytes(reinterpret_cast<const atUint8*>(str.data()), len);
       writeUByte(0);
     } else {
-      auto it = str.begin();
-      for (atInt32 i = 0; i < fixedLen; ++i) {
-        atUint8 chr;
-        if (it == str.end())
-          chr = 0;
-        else
-          chr = *it++;
-        writeUByte(chr);
-      }
+      const atUint64 len = std::min<atUint64>(str.size(), atUint64(fixedLen));
+      if (len)
+        writeUBytes(reinterpret_cast<const atUint8*>(str.data()), len);
+      fill(atUint8(0), atUint64(fixedLen) - len);
     }
   }
   void writeVal(std::string_view val) { writeString(val); }
@@ -1003,6 +1008,10 @@ public:
   void enumerate(const std::vector<T>& vector,
                  std::enable_if_t<std::is_arithmetic_v<T> || std::is_same_v<T, atVec2f> || std::is_same_v<T, atVec3f> ||
                                   std::is_same_v<T, atVec4f>>* = nullptr) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      _enumerateBulk(vector, m_endian);
+      return;
+    }
     for (const T& item : vector)
       writeVal(item);
   }
@@ -1016,6 +1025,10 @@ public:
   void enumerateLittle(const std::vector<T>& vector,
                        std::enable_if_t<std::is_arithmetic_v<T> || std::is_same_v<T, atVec2f> ||
                                         std::is_same_v<T, atVec3f> || std::is_same_v<T, atVec4f>>* = nullptr) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      _enumerateBulk(vector, Endian::Little);
+      return;
+    }
     for (const T& item : vector)
       writeValLittle(item);
   }
@@ -1029,6 +1042,10 @@ public:
   void enumerateBig(const std::vector<T>& vector,
                     std::enable_if_t<std::is_arithmetic_v<T> || std::is_same_v<T, atVec2f> ||
                                      std::is_same_v<T, atVec3f> || std::is_same_v<T, atVec4f>>* = nullptr) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      _enumerateBulk(vector, Endian::Big);
+      return;
+    }
     for (const T& item : vector)
       writeValBig(item);
   }
@@ -1043,6 +1060,26 @@ public:
     for (const T& item : vector)
       item.write(*this);
   }
+
+private:
+  /* Writes the array as-is, or swapped through a staging buffer when the byte order differs */
+  template <class T>
+  void _enumerateBulk(const std::vector<T>& vector, Endian endian) {
+    if (vector.empty())
+      return;
+    if (sizeof(T) == 1 || endian == utility::SystemEndian) {
+      writeBytes(vector.data(), atUint64(vector.size()) * sizeof(T));
+      return;
+    }
+
+    constexpr size_t StageCount = 4096 / sizeof(T);
+    T stage[StageCount];
+    for (size_t i = 0; i < vector.size(); i += StageCount) {
+      const size_t n = std::min(StageCount, vector.size() - i);
+      utility::swapArray(stage, vector.data() + i, n);
+      writeBytes(stage, atUint64(n) * sizeof(T));
+    }
+  }
 };
 
 template <typename T>
@@ -0,0 +1,70 @@
+#pragma once
+
+#if _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+#include <string>
+#include <string_view>
+
+#include "athena/MemoryReader.hpp"
+
+namespace athena::io {
+/*! \class MappedFileReader
+ *  \brief A MemoryReader backed by a read-only memory mapping of a file
+ *
+ *  The whole file is mapped on open() and read directly out of the page cache,
+ *  so opening costs the same regardless of file size and no private copy of the
+ *  contents is made (unlike MemoryCopyReader). The mapping stays valid until
+ *  close() or destruction; span() returns it without copying.
+ *  \sa MemoryReader
+ */
+class MappedFileReader : public MemoryReader {
+public:
+  /*! \brief Maps the specified file for reading.
+   *
+   *   \param filename  The file to map
+   *   \param globalErr Whether or not global errors are enabled.
+   */
+  explicit MappedFileReader(std::string_view filename, bool globalErr = true);
+  explicit MappedFileReader(std::wstring_view filename, bool globalErr = true);
+  ~MappedFileReader() override;
+
+  MappedFileReader(const MappedFileReader&) = delete;
+  MappedFileReader& operator=(const MappedFileReader&) = delete;
+
+  std::string filename() const {
+#if _WIN32
+    return utility::wideToUtf8(m_filename);
+#else
+    return m_filename;
+#endif
+  }
+
+  std::wstring wfilename() const {
+#if _WIN32
+    return m_filename;
+#else
+    return utility::utf8ToWide(m_filename);
+#endif
+  }
+
+  void open();
+  void close();
+  bool isOpen() const { return m_isOpen; }
+
+private:
+#if _WIN32
+  std::wstring m_filename;
+  HANDLE m_mappingHandle = nullptr;
+#else
+  std::string m_filename;
+#endif
+  void* m_mapping = nullptr;
+  atUint64 m_mappingSize = 0;
+  bool m_isOpen = false;
+};
+} // namespace athena::io
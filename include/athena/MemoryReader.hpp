@@ -3,6 +3,7 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <span>
 #include "athena/IStreamReader.hpp"
 
 namespace athena::io {
@@ -70,6 +71,12 @@ public:
    */
   atUint8* data() const;
 
+  /*! \brief Returns the current buffer without copying.
+   *
+   *  \return The whole buffer; only valid as long as the reader keeps it.
+   */
+  std::span<const atUint8> span() const { return {static_cast<const atUint8*>(m_data), size_t(m_length)}; }
+
   /*! \brief Reads a specified number of bytes to user-allocated buffer
    *  \param buf User-allocated buffer pointer
    *  \param len Length to read
@@ -78,6 +85,8 @@ public:
   atUint64 readUBytesToBuf(void* buf, atUint64 len) override;
 
 protected:
+  std::span<const atUint8> _contiguousSpan(atUint64 length) override;
+
   const void* m_data = nullptr;
   atUint64 m_length = 0;
   atUint64 m_position = 0;
@@ -139,11 +139,35 @@ public:
    */
   void writeUBytes(const atUint8* data, atUint64 length) override;
 
+  /*! @brief Makes room for the buffer to grow to the given size without reallocating.
+   *
+   *  @param capacity The number of bytes to allocate up front
+   */
+  void reserve(atUint64 capacity);
+
+  /*! @brief Returns the number of bytes allocated, which may exceed length().
+   */
+  atUint64 capacity() const { return m_capacity; }
+
+  /*! @brief Frees any allocated space beyond length().
+   */
+  void shrinkToFit();
+
+  /*! @brief Hands the buffer over to the caller without copying it.<br />
+   *         The first length() bytes are the written data; query length() before calling,
+   *         since the writer is left empty afterwards.
+   *  @return The buffer, which may be larger than length()
+   */
+  std::unique_ptr<atUint8[]> release();
+
 protected:
   std::unique_ptr<atUint8[]> m_dataCopy;
 
 private:
   void resize(atUint64 newSize);
+  void grow(atUint64 minCapacity);
+
+  atUint64 m_capacity = 0;
 };
 
 } // namespace athena::io
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "athena/FileReader.hpp"
+
+namespace athena::io {
+/*! \class PrefetchingFileReader
+ *  \brief A FileReader that reads ahead of the current position on a worker thread
+ *
+ *  A ring of blockCount blocks is kept filled with the data following the current
+ *  position, so sequential reads only copy out of memory while the next blocks are
+ *  being fetched. Seeking outside the ring restarts read-ahead at the new position.
+ *  While read-ahead is running, only the worker thread touches the file handle.
+ *  \sa FileReader
+ */
+class PrefetchingFileReader : public FileReader {
+public:
+  /*! \brief Opens the file and starts reading ahead from the beginning.
+   *
+   *   \param filename   The file to read
+   *   \param blockSize  Size of each read-ahead block in bytes
+   *   \param blockCount Number of blocks kept ahead of the current position
+   *   \param globalErr  Whether or not global errors are enabled.
+   */
+  explicit PrefetchingFileReader(std::string_view filename, atInt32 blockSize = (256 * 1024), atUint32 blockCount = 4,
+                                 bool globalErr = true);
+  explicit PrefetchingFileReader(std::wstring_view filename, atInt32 blockSize = (256 * 1024),
+                                 atUint32 blockCount = 4, bool globalErr = true);
+  ~PrefetchingFileReader() override;
+
+  /*! \brief Reopens the file and restarts reading ahead. */
+  void open() override;
+
+  /*! \brief Stops the worker thread and closes the file. */
+  void close() override;
+
+  /*! \brief Re-reads the file size and restarts reading ahead with it. */
+  void refreshLength() override;
+
+  /*! \brief Resizes the read-ahead ring, stopping the worker while it does.
+   *
+   *  The ring takes the place of FileReader's cache, so this never enables that.
+   */
+  void setCacheSize(atInt32 blockSize, atUint32 blockCount = 4) override;
+
+  atUint64 readUBytesToBuf(void* buf, atUint64 len) override;
+
+  /*! \brief Number of times a read had to wait for the worker to fill a block. */
+  atUint64 stallCount() const { return m_stallCount; }
+
+protected:
+  std::span<const atUint8> _contiguousSpan(atUint64 length) override;
+
+private:
+  void _start();
+  void _stop();
+  void _worker();
+  CacheBlock& _headSlot(std::unique_lock<std::mutex>& lk);
+  void _reportWorkerError();
+
+  std::vector<CacheBlock> m_ring;
+  atUint64 m_ringBlockSize = 0;
+  atUint64 m_prefetchSize = 0; // m_fileSize as of _start(), so the worker never reads m_fileSize itself
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_workerCv;
+  std::condition_variable m_readerCv;
+  atInt64 m_headBlock = 0;  // first block the reader still needs
+  atInt64 m_fetchBlock = 0; // next block the worker will start on
+  atUint64 m_generation = 0;
+  atUint64 m_stallCount = 0;
+  bool m_stopping = false;
+  bool m_workerError = false; // set by the worker, reported on the reader thread
+};
+} // namespace athena::io
@@ -0,0 +1,120 @@
+#pragma once
+
+#if _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "athena/IStreamReader.hpp"
+
+namespace athena::io {
+/*! \class SharedFile
+ *  \brief A read-only file handle that can be read from several threads at once
+ *
+ *  All reads are positional (pread / overlapped ReadFile), so the handle has no
+ *  cursor of its own and never changes after open. Share it between threads with
+ *  a std::shared_ptr and give each thread its own SharedFileReader.
+ *  \sa SharedFileReader
+ */
+class SharedFile {
+public:
+  explicit SharedFile(std::string_view filename, bool globalErr = true);
+  explicit SharedFile(std::wstring_view filename, bool globalErr = true);
+  ~SharedFile();
+
+  SharedFile(const SharedFile&) = delete;
+  SharedFile& operator=(const SharedFile&) = delete;
+
+  std::string filename() const {
+#if _WIN32
+    return utility::wideToUtf8(m_filename);
+#else
+    return m_filename;
+#endif
+  }
+
+  std::wstring wfilename() const {
+#if _WIN32
+    return m_filename;
+#else
+    return utility::utf8ToWide(m_filename);
+#endif
+  }
+
+  bool isOpen() const { return m_isOpen; }
+  atUint64 length() const { return m_length; }
+
+  /*! \brief Reads len bytes starting at offset; safe to call concurrently.
+   *
+   *  \return The number of bytes actually read
+   */
+  atUint64 readAt(atUint64 offset, void* buf, atUint64 len) const;
+
+private:
+  void open();
+
+#if _WIN32
+  std::wstring m_filename;
+  HANDLE m_fileHandle = INVALID_HANDLE_VALUE;
+#else
+  std::string m_filename;
+  int m_fileHandle = -1;
+#endif
+  atUint64 m_length = 0;
+  bool m_isOpen = false;
+  bool m_globalErr;
+};
+
+/*! \class SharedFileReader
+ *  \brief A lightweight cursor over a SharedFile, optionally limited to a sub-range
+ *
+ *  Each reader has its own position and a small read buffer, so different threads
+ *  can parse different parts of the same file without locking or reopening it.
+ *  A single reader is not meant to be used from several threads at once.
+ *  \sa SharedFile
+ */
+class SharedFileReader : public IStreamReader {
+public:
+  /*! \brief Creates a cursor over [offset, offset + length) of file.
+   *
+   *   \param file       The file to read from
+   *   \param offset     Start of the range within the file
+   *   \param length     Length of the range; clamped to the end of the file
+   *   \param bufferSize Size of the read buffer used for small reads, 0 to disable buffering
+   *   \param globalErr  Whether or not global errors are enabled.
+   */
+  explicit SharedFileReader(std::shared_ptr<const SharedFile> file, atUint64 offset = 0,
+                            atUint64 length = UINT64_MAX, atUint32 bufferSize = 4096, bool globalErr = true);
+
+  void seek(atInt64 pos, SeekOrigin origin = SeekOrigin::Current) override;
+  atUint64 position() const override { return m_position; }
+  atUint64 length() const override { return m_length; }
+  atUint64 readUBytesToBuf(void* buf, atUint64 len) override;
+
+  const std::shared_ptr<const SharedFile>& file() const { return m_file; }
+
+  /*! \brief Offset of this reader's range within the file. */
+  atUint64 baseOffset() const { return m_base; }
+
+protected:
+  std::span<const atUint8> _contiguousSpan(atUint64 length) override;
+
+private:
+  std::shared_ptr<const SharedFile> m_file;
+  atUint64 m_base;
+  atUint64 m_length = 0;
+  atUint64 m_position = 0;
+  std::unique_ptr<atUint8[]> m_buffer;
+  atUint64 m_bufferSize;
+  atUint64 m_bufferStart = 0;
+  atUint64 m_bufferFill = 0;
+  bool m_globalErr;
+};
+} // namespace athena::io
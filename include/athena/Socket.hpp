@@ -10,6 +10,7 @@ using SOCKET = UINT_PTR;
 #endif
 
 struct sockaddr_in;
+struct atIoSlice;
 
 namespace athena::net {
 
@@ -70,6 +71,9 @@ public:
   void close();
   EResult send(const void* buf, size_t len, size_t& transferred);
   EResult send(const void* buf, size_t len);
+  /** Sends several buffers back to back with as few system calls as possible (sendmsg / WSASend) */
+  EResult send(const atIoSlice* slices, size_t count, size_t& transferred);
+  EResult send(const atIoSlice* slices, size_t count);
   EResult recv(void* buf, size_t len, size_t& transferred);
   EResult recv(void* buf, size_t len);
 
@@ -12,6 +12,12 @@ using atUint32 = std::uint32_t;
 using atInt64 = std::int64_t;
 using atUint64 = std::uint64_t;
 
+// Scatter-gather segment, as consumed by IStreamWriter::writeUBytesV
+struct atIoSlice {
+  const atUint8* data;
+  atUint64 length;
+};
+
 // Vector types
 #include "simd/simd.hpp"
 struct atVec2f {
@@ -4,6 +4,7 @@
 #include <cstring>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "athena/Global.hpp"
@@ -175,6 +176,40 @@ BSWAP_CONSTEXPR double BigDouble(double val) {
   return val;
 }
 
+/* Byte-swap count 16/32/64-bit units from src into dst; dst may equal src.
+ * Uses SSE2/AVX2/NEON where available */
+void swapCopy16(void* dst, const void* src, atUint64 count);
+void swapCopy32(void* dst, const void* src, atUint64 count);
+void swapCopy64(void* dst, const void* src, atUint64 count);
+
+/* Index of the first all-zero 16/32-bit unit among count units, or count if there is none */
+atUint64 findZero16(const void* data, atUint64 count);
+atUint64 findZero32(const void* data, atUint64 count);
+
+template <class T>
+void swapArray(T* data, atUint64 count) {
+  static_assert(std::is_arithmetic_v<T>, "swapArray only handles plain numbers");
+  if constexpr (sizeof(T) == 2)
+    swapCopy16(data, data, count);
+  else if constexpr (sizeof(T) == 4)
+    swapCopy32(data, data, count);
+  else if constexpr (sizeof(T) == 8)
+    swapCopy64(data, data, count);
+}
+
+template <class T>
+void swapArray(T* dst, const T* src, atUint64 count) {
+  static_assert(std::is_arithmetic_v<T>, "swapArray only handles plain numbers");
+  if constexpr (sizeof(T) == 2)
+    swapCopy16(dst, src, count);
+  else if constexpr (sizeof(T) == 4)
+    swapCopy32(dst, src, count);
+  else if constexpr (sizeof(T) == 8)
+    swapCopy64(dst, src, count);
+  else if (dst != src)
+    std::memcpy(dst, src, count * sizeof(T));
+}
+
 void fillRandom(atUint8* rndArea, atUint64 count);
 std::vector<std::string> split(std::string_view s, char delim);
 atUint64 rand64();
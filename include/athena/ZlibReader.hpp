@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+
+#include "athena/IStreamReader.hpp"
+
+struct z_stream_s;
+
+namespace athena::io {
+/*! \class ZlibReader
+ *  \brief Inflates a zlib or gzip stream from another reader as it is read
+ *
+ *  Only a fixed-size input buffer and a window of recently decompressed data are held;
+ *  large reads go straight into the caller's buffers. Seeking and peeking within the
+ *  window (which keeps 4 KiB behind the position) is free. Seeking further forward
+ *  decompresses and discards, seeking further back starts over from the beginning of
+ *  the compressed data.
+ *  The source is read sequentially and must not be moved by anyone else meanwhile.
+ */
+class ZlibReader : public IStreamReader {
+public:
+  /*! \brief Starts inflating at source's current position.
+   *
+   *   \param source             The reader the compressed data comes from
+   *   \param compressedLength   Number of compressed bytes available from source
+   *   \param uncompressedLength Size of the decompressed data
+   *   \param bufferSize         Size of the compressed input buffer
+   *   \param globalErr          Whether or not global errors are enabled.
+   */
+  ZlibReader(IStreamReader& source, atUint64 compressedLength, atUint64 uncompressedLength,
+             atUint32 bufferSize = 0x10000, bool globalErr = true);
+  ~ZlibReader() override;
+
+  /*! \brief Reuses this reader (and its zlib state) for another stream at source's current position. */
+  void reset(IStreamReader& source, atUint64 compressedLength, atUint64 uncompressedLength);
+
+  void seek(atInt64 pos, SeekOrigin origin = SeekOrigin::Current) override;
+  atUint64 position() const override { return m_position; }
+  atUint64 length() const override { return m_length; }
+  atUint64 readUBytesToBuf(void* buf, atUint64 len) override;
+
+protected:
+  std::span<const atUint8> _contiguousSpan(atUint64 length) override;
+
+private:
+  static constexpr atUint64 History = 0x1000;
+
+  void _rewind();
+  bool _fill();
+  atUint64 _inflate(atUint8* dst, atUint64 len);
+
+  IStreamReader* m_source;
+  atUint64 m_sourceStart = 0;
+  atUint64 m_compressedLength = 0;
+  atUint64 m_compressedRead = 0;
+  std::unique_ptr<z_stream_s> m_strm;
+  std::unique_ptr<atUint8[]> m_inBuf;
+  std::unique_ptr<atUint8[]> m_window; // decompressed data from m_windowStart to m_decoded
+  atUint32 m_bufferSize;
+  atUint64 m_windowStart = 0;
+  atUint64 m_windowLen = 0;
+  atUint64 m_decoded = 0;
+  atUint64 m_position = 0;
+  atUint64 m_length = 0;
+  bool m_streamOk = false;
+  bool m_globalErr;
+};
+} // namespace athena::io
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+
+#include "athena/IStreamWriter.hpp"
+
+struct z_stream_s;
+
+namespace athena::io {
+/*! \class ZlibWriter
+ *  \brief Deflates everything written to it into another writer as a zlib stream
+ *
+ *  Compressed output is collected in a fixed-size buffer and handed to the sink
+ *  whenever it fills up, so neither the whole input nor the whole output is held.
+ *  The stream is completed by finish(), or by the destructor if it wasn't called.
+ */
+class ZlibWriter : public IStreamWriter {
+public:
+  /*! \brief Creates a writer that compresses into sink at its current position.
+   *
+   *   \param sink       The writer the compressed data goes to
+   *   \param level      Compression level from 0 to 9, or -1 for zlib's default
+   *   \param strategy   A zlib Z_* strategy value; 0 is Z_DEFAULT_STRATEGY
+   *   \param bufferSize Size of the compressed output buffer
+   *   \param globalErr  Whether or not global errors are enabled.
+   */
+  explicit ZlibWriter(IStreamWriter& sink, atInt32 level = -1, atInt32 strategy = 0, atUint32 bufferSize = 0x10000,
+                      bool globalErr = true);
+  ~ZlibWriter() override;
+
+  /*! \brief Finishes the current stream if needed and starts a new one into sink, reusing the zlib state. */
+  void reset(IStreamWriter& sink);
+
+  /*! \brief Flushes the remaining compressed data and ends the stream; nothing can be written afterwards. */
+  void finish();
+
+  /*! \brief Only seeking forward is supported; the gap is filled with zeros. */
+  void seek(atInt64 pos, SeekOrigin origin = SeekOrigin::Current) override;
+  atUint64 position() const override { return m_position; }
+  atUint64 length() const override { return m_position; }
+  void writeUBytes(const atUint8* data, atUint64 length) override;
+
+  /*! \brief Number of compressed bytes handed to the sink so far. */
+  atUint64 compressedLength() const { return m_compressedLength; }
+
+private:
+  bool _deflate(const atUint8* data, atUint64 length, int flush);
+
+  IStreamWriter* m_sink;
+  std::unique_ptr<z_stream_s> m_strm;
+  std::unique_ptr<atUint8[]> m_outBuf;
+  atUint32 m_bufferSize;
+  atUint64 m_position = 0;
+  atUint64 m_compressedLength = 0;
+  bool m_streamOk = false;
+  bool m_finished = false;
+  bool m_globalErr;
+};
+} // namespace athena::io
@@ -1,6 +1,10 @@
 #include "LZ77/LZLookupTable.hpp"
 #include "LZ77/LZBase.hpp"
 
+#include <cstring>
+
+#include <athena/Utility.hpp>
+
 namespace {
 // Returns the full length of string2 if they are equal else
 // Return the number of characters that were equal before they weren't equal
@@ -89,6 +93,37 @@ void LZBase::setMinimumOffset(atUint32 minimumOffset) { m_minOffset = minimumOff
 
 atUint32 LZBase::minimumOffset() const { return m_minOffset; }
 
+atUint32 LZBase::decompressedSize(const atUint8* src) {
+  atUint32 header;
+  std::memcpy(&header, src, sizeof(header));
+  athena::utility::LittleUint32(header); // The compressed file has the filesize encoded in little endian
+
+  // First byte is the encode flag; type 0x11 stores sizes over 24 bits in the next 4 bytes instead
+  atUint32 size = header >> 8;
+  if (size == 0 && (header & 0xFF) == 0x11) {
+    std::memcpy(&size, src + 4, sizeof(size));
+    athena::utility::LittleUint32(size);
+  }
+  return size;
+}
+
+void LZBase::copyMatch(atUint8* out, atUint32 offset, atUint32 length) {
+  const atUint8* from = out - offset;
+  if (offset >= 8) {
+    // Eight bytes at a time never read anything this same copy writes
+    atUint32 i = 0;
+    for (; i + 8 <= length; i += 8)
+      std::memcpy(out + i, from + i, 8);
+    for (; i < length; ++i)
+      out[i] = from[i];
+  } else if (offset == 1) {
+    std::memset(out, *from, length);
+  } else {
+    for (atUint32 i = 0; i < length; ++i)
+      out[i] = from[i];
+  }
+}
+
 /*
   DerricMc:
   This search function is my own work and is no way affiliated with any one else
@@ -1,7 +1,12 @@
 #include "LZ77/LZLookupTable.hpp"
 #include <algorithm>
+#include <cstring>
 
-LZLookupTable::LZLookupTable() : m_buffer(m_minimumMatch) {}
+namespace {
+constexpr atUint32 HashBits = 14;
+}
+
+LZLookupTable::LZLookupTable() = default;
 
 LZLookupTable::LZLookupTable(atInt32 minimumMatch, atInt32 slidingWindow, atInt32 lookAheadWindow) {
   if (minimumMatch > 0)
@@ -15,8 +20,6 @@ LZLookupTable::LZLookupTable(atInt32 minimumMatch, atInt32 slidingWindow, atInt3
     m_slidingWindow = 4096;
 
   setLookAheadWindow(lookAheadWindow);
-
-  m_buffer.reserve(m_minimumMatch);
 }
 
 LZLookupTable::~LZLookupTable() = default;
@@ -37,32 +40,35 @@ LZLengthOffset LZLookupTable::search(const atUint8* curPos, const atUint8* dataB
     return loPair;
   }
 
-  std::copy(curPos, curPos + m_minimumMatch, m_buffer.begin());
+  // A new buffer (or the start of the same one again) begins with an empty window
+  if (dataBegin != m_dataBegin || curPos == dataBegin)
+    reset(dataBegin);
+
   int32_t currentOffset = static_cast<atInt32>(curPos - dataBegin);
 
   // Find code
   if (currentOffset > 0 && (dataEnd - curPos) >= m_minimumMatch) {
-    auto elements = table.equal_range(m_buffer);
-    elements.second--;
-    elements.first--;
+    const int32_t lookAheadBufferLength =
+        ((dataEnd - curPos) < m_lookAheadWindow) ? static_cast<int32_t>(dataEnd - curPos) : m_lookAheadWindow;
+    const int32_t windowStart = currentOffset - m_slidingWindow;
 
-    // Iterate over keys in reverse order. C++11 guarantees that the relative order of elements is maintained for the
-    // same key
-    for (auto iter = elements.second; iter != elements.first; iter--) {
-      int32_t matchLength = m_minimumMatch;
-      int32_t lookAheadBufferLength =
-          ((dataEnd - curPos) < m_lookAheadWindow) ? static_cast<int32_t>(dataEnd - curPos) : m_lookAheadWindow;
+    // Walk from the newest candidate to the oldest, so when lengths are the same the closer offset wins
+    for (int32_t candidate = m_head[hash(curPos)]; candidate >= 0 && candidate >= windowStart;
+         candidate = m_prev[candidate % m_slidingWindow]) {
+      const atUint8* match = dataBegin + candidate;
+      if (memcmp(match, curPos, m_minimumMatch) != 0)
+        continue;
 
+      int32_t matchLength = m_minimumMatch;
       for (; matchLength < lookAheadBufferLength; ++matchLength) {
-        if (*(dataBegin + iter->second + matchLength) != *(curPos + matchLength))
+        if (match[matchLength] != curPos[matchLength])
           break;
       }
 
       // Store the longest match found so far into length_offset struct.
-      // When lengths are the same the closer offset to the lookahead buffer wins
       if (loPair.length < (atUint32)matchLength) {
         loPair.length = matchLength;
-        loPair.offset = currentOffset - iter->second;
+        loPair.offset = currentOffset - candidate;
       }
 
       // Found the longest match so break out of loop
@@ -72,37 +78,36 @@ LZLengthOffset LZLookupTable::search(const atUint8* curPos, const atUint8* dataB
   }
 
   // end find code
-  // Insert code
-  table.insert(std::make_pair(m_buffer, currentOffset));
+  // Insert code; every position the caller will step over goes into the window
+  insert(dataBegin, dataEnd, currentOffset);
+  for (atUint32 i = 1; i < loPair.length; i++)
+    insert(dataBegin, dataEnd, currentOffset + i);
 
-  for (atUint32 i = 1; i < loPair.length; i++) {
-    if (dataEnd - (curPos + i) < m_minimumMatch)
-      break;
+  // end insert code
+  return loPair;
+}
 
-    std::copy(curPos + i, curPos + m_minimumMatch + i, m_buffer.begin());
-    table.insert(std::make_pair(m_buffer, currentOffset + i));
-  }
+void LZLookupTable::reset(const atUint8* dataBegin) {
+  // The chains are only allocated once something is compressed, so decoders never pay for them
+  m_dataBegin = dataBegin;
+  m_head.assign(1 << HashBits, -1);
+  m_prev.resize(m_slidingWindow);
+}
 
-  // end insert code
-  // Delete code
-  int32_t slidingWindowOffset = std::max(0, currentOffset - m_slidingWindow); // Absolute offset
-  int32_t tablesize = static_cast<int32_t>(table.size());
-
-  for (int32_t i = 0; i < tablesize - m_slidingWindow; ++i) {
-    std::copy(dataBegin + slidingWindowOffset + i, dataBegin + slidingWindowOffset + m_minimumMatch + i,
-              m_buffer.begin());
-    auto elements = table.equal_range(m_buffer);
-
-    for (auto iter = elements.first; iter != elements.second; iter++) {
-      if (slidingWindowOffset + i == iter->second) {
-        table.erase(iter);
-        // There should no occurance of the map with the same value
-        break;
-      }
-    }
-  }
+void LZLookupTable::insert(const atUint8* dataBegin, const atUint8* dataEnd, atInt32 offset) {
+  // Positions too close to the end can never be matched against
+  if (dataEnd - (dataBegin + offset) < m_minimumMatch)
+    return;
 
-  // end delete code
-  return loPair;
-  // break lookupTable.cpp:109 if table.size()> 4096
+  atUint32 h = hash(dataBegin + offset);
+  m_prev[offset % m_slidingWindow] = m_head[h];
+  m_head[h] = offset;
+}
+
+atUint32 LZLookupTable::hash(const atUint8* ptr) const {
+  // Only the first few bytes feed the hash; candidates are compared in full anyway
+  atUint32 v = 0;
+  for (atInt32 i = 0; i < std::min(m_minimumMatch, 3); ++i)
+    v = (v << 8) | ptr[i];
+  return (v * 2654435761u) >> (32 - HashBits);
 }
@@ -1,5 +1,6 @@
 #include "LZ77/LZType10.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <memory>
@@ -19,7 +20,7 @@ atUint32 LZType10::compress(const atUint8* src, atUint8** dstBuf, atUint32 srcLe
   atUint32 encodeSize = (srcLength << 8) | (0x10);
   encodeSize = athena::utility::LittleUint32(encodeSize); // File size needs to be written as little endian always
 
-  athena::io::MemoryCopyWriter outbuf("tmp");
+  athena::io::MemoryCopyWriter outbuf;
   outbuf.writeUint32(encodeSize);
 
   const atUint8* ptrStart = src;
@@ -63,14 +64,15 @@ atUint32 LZType10::compress(const atUint8* src, atUint8** dstBuf, atUint32 srcLe
     outbuf.writeUBytes(compressedBytes.get(), static_cast<atUint64>(ptrBytes - compressedBytes.get()));
   }
 
-  // Add zeros until the file is a multiple of 4
-  while ((outbuf.position() % 4) != 0) {
+  // Add zeros until the file is a multiple of 4, and at least 0x10 bytes like it always was
+  while ((outbuf.position() % 4) != 0 || outbuf.position() < 0x10) {
     outbuf.writeByte(0);
   }
 
-  *dstBuf = outbuf.data();
-  outbuf.save();
-  return static_cast<atUint32>(outbuf.length());
+  // Hand the buffer over instead of copying it
+  const auto compressedLength = static_cast<atUint32>(outbuf.position());
+  *dstBuf = outbuf.release().release();
+  return compressedLength;
 }
 
 atUint32 LZType10::decompress(const atUint8* src, atUint8** dst, atUint32 srcLength) {
@@ -79,29 +81,47 @@ atUint32 LZType10::decompress(const atUint8* src, atUint8** dst, atUint32 srcLen
   }
 
   // Size of data when it is uncompressed
-  atUint32 uncompressedSize;
-  std::memcpy(&uncompressedSize, src, sizeof(uncompressedSize));
+  const atUint32 uncompressedSize = decompressedSize(src);
 
-  // The compressed file has the filesize encoded in little endian
-  athena::utility::LittleUint32(uncompressedSize);
+  auto uncompressedData = std::unique_ptr<atUint8[]>(new atUint8[uncompressedSize]);
+  if (decompressInto(src, srcLength, uncompressedData.get(), uncompressedSize) != uncompressedSize) {
+    return 0;
+  }
 
-  // first byte is the encode flag
-  uncompressedSize = uncompressedSize >> 8;
+  *dst = uncompressedData.release();
 
-  auto uncompressedData = std::unique_ptr<atUint8[]>(new atUint8[uncompressedSize]);
-  atUint8* outputPtr = uncompressedData.get();
-  atUint8* outputEndPtr = uncompressedData.get() + uncompressedSize;
+  return uncompressedSize;
+}
+
+atUint32 LZType10::decompressInto(const atUint8* src, atUint32 srcLength, atUint8* dst, atUint32 dstLength) {
+  if (srcLength < 4 || *src != 0x10) {
+    return 0;
+  }
+
+  const atUint32 uncompressedSize = decompressedSize(src);
+  if (uncompressedSize > dstLength) {
+    return 0;
+  }
+
+  atUint8* outputPtr = dst;
+  atUint8* outputEndPtr = dst + uncompressedSize;
   const atUint8* inputPtr = src + 4;
   const atUint8* inputEndPtr = src + srcLength;
 
-  while (inputPtr < inputEndPtr && outputPtr < outputEndPtr) {
+  while (outputPtr < outputEndPtr) {
+    if (inputPtr >= inputEndPtr) {
+      return 0;
+    }
     const atUint8 isCompressed = *inputPtr++;
 
-    for (atUint32 i = 0; i < static_cast<atUint32>(m_blockSize); i++) {
+    for (atUint32 i = 0; i < static_cast<atUint32>(m_blockSize) && outputPtr < outputEndPtr; i++) {
       // Checks to see if the next byte is compressed by looking
       // at its binary representation - E.g 10010000
       // This says that the first extracted byte and the four extracted byte is compressed
       if ((isCompressed >> (7 - i)) & 0x1) {
+        if (inputEndPtr - inputPtr < 2) {
+          return 0;
+        }
         atUint16 lenOff;
         memcpy(&lenOff, inputPtr, sizeof(atUint16));
         athena::utility::BigUint16(lenOff);
@@ -111,29 +131,24 @@ atUint32 LZType10::decompress(const atUint8* src, atUint8** dst, atUint32 srcLen
         decoding.length = (lenOff >> 12) + m_minMatch;
         decoding.offset = static_cast<atUint16>((lenOff & 0xFFF) + 1);
 
-        if ((outputPtr - decoding.offset) < uncompressedData.get()) {
+        if (decoding.offset > outputPtr - dst) {
           // If the offset to look for uncompressed is passed the current uncompresed data then the data is not
           // compressed
-          dst = nullptr;
           return 0;
         }
 
-        for (size_t j = 0; j < decoding.length; ++j) {
-          outputPtr[j] = (outputPtr - decoding.offset)[j];
-        }
-
-        outputPtr += decoding.length;
+        // The last match may run past the end of the data; the rest of it is padding
+        const atUint32 length = std::min<atUint32>(decoding.length, outputEndPtr - outputPtr);
+        copyMatch(outputPtr, decoding.offset, length);
+        outputPtr += length;
       } else {
+        if (inputPtr >= inputEndPtr) {
+          return 0;
+        }
         *outputPtr++ = *inputPtr++;
       }
-
-      if (!(inputPtr < inputEndPtr && outputPtr < outputEndPtr)) {
-        break;
-      }
     }
   }
 
-  *dst = uncompressedData.release();
-
   return uncompressedSize;
 }
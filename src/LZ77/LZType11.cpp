@@ -1,5 +1,6 @@
 #include "LZ77/LZType11.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <memory>
@@ -15,7 +16,7 @@ LZType11::LZType11(atInt32 minimumOffset, atInt32 slidingWindow, atInt32 minimum
 }
 
 atUint32 LZType11::compress(const atUint8* src, atUint8** dst, atUint32 srcLength) {
-  athena::io::MemoryCopyWriter outbuff("tmp");
+  athena::io::MemoryCopyWriter outbuff;
 
   if (srcLength > 0xFFFFFF) { // If length is greater than 24 bits or 16 Megs
     atUint32 encodeFlag = 0x11;
@@ -32,11 +33,11 @@ atUint32 LZType11::compress(const atUint8* src, atUint8** dst, atUint32 srcLengt
   const atUint8* ptrStart = src;
   const atUint8* ptrEnd = src + srcLength;
 
-  // At most their will be two bytes written if the bytes can be compressed. So if all bytes in the block can be
-  // compressed it would take blockSize*2 bytes
+  // At most their will be four bytes written if the bytes can be compressed. So if all bytes in the block can be
+  // compressed it would take blockSize*4 bytes
 
   // Holds the compressed bytes yet to be written
-  auto compressedBytes = std::unique_ptr<atUint8[]>(new atUint8[m_blockSize * 2]);
+  auto compressedBytes = std::unique_ptr<atUint8[]>(new atUint8[m_blockSize * 4]);
 
   const atUint8 maxTwoByteMatch = 0xF + 1;
   const atUint8 minThreeByteMatch = maxTwoByteMatch + 1; // Minimum Three byte match is maximum TwoByte match + 1
@@ -111,13 +112,15 @@ atUint32 LZType11::compress(const atUint8* src, atUint8** dst, atUint32 srcLengt
     outbuff.writeUBytes(compressedBytes.get(), static_cast<atUint64>(ptrBytes - compressedBytes.get()));
   }
 
-  // Add zeros until the file is a multiple of 4
-  while ((outbuff.position() % 4) != 0) {
+  // Add zeros until the file is a multiple of 4, and at least 0x10 bytes like it always was
+  while ((outbuff.position() % 4) != 0 || outbuff.position() < 0x10) {
     outbuff.writeByte(0);
   }
 
-  *dst = outbuff.data();
-  return static_cast<atUint32>(outbuff.length());
+  // Hand the buffer over instead of copying it
+  const auto compressedLength = static_cast<atUint32>(outbuff.position());
+  *dst = outbuff.release().release();
+  return compressedLength;
 }
 
 atUint32 LZType11::decompress(const atUint8* src, atUint8** dst, atUint32 srcLength) {
@@ -125,23 +128,35 @@ atUint32 LZType11::decompress(const atUint8* src, atUint8** dst, atUint32 srcLen
     return 0;
   }
 
-  atUint32 uncompressedLen;
-  std::memcpy(&uncompressedLen, src, sizeof(uncompressedLen));
-  athena::utility::LittleUint32(uncompressedLen); // The compressed file has the filesize encoded in little endian
-  uncompressedLen = uncompressedLen >> 8;         // First byte is the encode flag
-  atUint32 currentOffset = 4;
-
-  // If the filesize var is zero then the true filesize is over 14MB and must be read in from the next 4 bytes
-  if (uncompressedLen == 0) {
-    atUint32 filesize;
-    std::memcpy(&filesize, src + 4, sizeof(filesize));
-    filesize = athena::utility::LittleUint32(filesize);
-    currentOffset += 4;
-  }
+  const atUint32 uncompressedLen = decompressedSize(src);
 
   auto uncompressedData = std::unique_ptr<atUint8[]>(new atUint8[uncompressedLen]);
-  atUint8* outputPtr = uncompressedData.get();
-  atUint8* outputEndPtr = uncompressedData.get() + uncompressedLen;
+  if (decompressInto(src, srcLength, uncompressedData.get(), uncompressedLen) != uncompressedLen) {
+    return 0;
+  }
+
+  *dst = uncompressedData.release();
+  return uncompressedLen;
+}
+
+atUint32 LZType11::decompressInto(const atUint8* src, atUint32 srcLength, atUint8* dst, atUint32 dstLength) {
+  if (srcLength < 4 || *src != 0x11) {
+    return 0;
+  }
+
+  // If the 24-bit size is zero then the true filesize is over 14MB and is stored in the next 4 bytes
+  atUint32 currentOffset = (src[1] | src[2] | src[3]) ? 4 : 8;
+  if (srcLength < currentOffset) {
+    return 0;
+  }
+
+  const atUint32 uncompressedLen = decompressedSize(src);
+  if (uncompressedLen > dstLength) {
+    return 0;
+  }
+
+  atUint8* outputPtr = dst;
+  atUint8* outputEndPtr = dst + uncompressedLen;
   const atUint8* inputPtr = src + currentOffset;
   const atUint8* inputEndPtr = src + srcLength;
 
@@ -151,17 +166,26 @@ atUint32 LZType11::decompress(const atUint8* src, atUint8** dst, atUint32 srcLen
   const atUint16 maxThreeByteMatch = 0xFF + threeByteDenorm;
   const atUint16 fourByteDenorm = maxThreeByteMatch + 1;
 
-  while (inputPtr < inputEndPtr && outputPtr < outputEndPtr) {
+  while (outputPtr < outputEndPtr) {
+    if (inputPtr >= inputEndPtr) {
+      return 0;
+    }
     const atUint8 isCompressed = *inputPtr++;
 
-    for (atInt32 i = 0; i < m_blockSize; i++) {
+    for (atInt32 i = 0; i < m_blockSize && outputPtr < outputEndPtr; i++) {
       // Checks to see if the next byte is compressed by looking
       // at its binary representation - E.g 10010000
       // This says that the first extracted byte and the four extracted byte is compressed
       if ((isCompressed >> (7 - i)) & 0x1) {
+        if (inputPtr >= inputEndPtr) {
+          return 0;
+        }
         const atUint8 metaDataSize = *inputPtr >> 4; // Look at the top 4 bits
 
         if (metaDataSize >= 2) { // Two Bytes of Length/Offset MetaData
+          if (inputEndPtr - inputPtr < 2) {
+            return 0;
+          }
           atUint16 lenOff = 0;
           memcpy(&lenOff, inputPtr, 2);
           inputPtr += 2;
@@ -169,13 +193,19 @@ atUint32 LZType11::decompress(const atUint8* src, atUint8** dst, atUint32 srcLen
           decoding.length = (lenOff >> 12) + 1;
           decoding.offset = (lenOff & 0xFFF) + 1;
         } else if (metaDataSize == 0) { // Three Bytes of Length/Offset MetaData
+          if (inputEndPtr - inputPtr < 3) {
+            return 0;
+          }
           atUint32 lenOff = 0;
           memcpy(reinterpret_cast<atUint8*>(&lenOff) + 1, inputPtr, 3);
           inputPtr += 3;
           athena::utility::BigUint32(lenOff);
           decoding.length = (lenOff >> 12) + threeByteDenorm;
           decoding.offset = (lenOff & 0xFFF) + 1;
-        } else if (metaDataSize == 1) { // Four Bytes of Length/Offset MetaData
+        } else { // Four Bytes of Length/Offset MetaData
+          if (inputEndPtr - inputPtr < 4) {
+            return 0;
+          }
           atUint32 lenOff = 0;
           memcpy(&lenOff, inputPtr, 4);
           inputPtr += 4;
@@ -183,31 +213,26 @@ atUint32 LZType11::decompress(const atUint8* src, atUint8** dst, atUint32 srcLen
 
           decoding.length = ((lenOff >> 12) & 0xFFFF) + fourByteDenorm; // Gets rid of the Four byte flag
           decoding.offset = (lenOff & 0xFFF) + 1;
-        } else {
-          return 0;
         }
 
         // If the offset to look for uncompressed is passed the
         // current uncompresed data then the data is not compressed
-        if ((outputPtr - decoding.offset) < uncompressedData.get()) {
+        if (decoding.offset > outputPtr - dst) {
           return 0;
         }
 
-        for (size_t j = 0; j < decoding.length; ++j) {
-          outputPtr[j] = (outputPtr - decoding.offset)[j];
-        }
-
-        outputPtr += decoding.length;
+        // The last match may run past the end of the data; the rest of it is padding
+        const atUint32 length = std::min<atUint32>(decoding.length, outputEndPtr - outputPtr);
+        copyMatch(outputPtr, decoding.offset, length);
+        outputPtr += length;
       } else {
+        if (inputPtr >= inputEndPtr) {
+          return 0;
+        }
         *outputPtr++ = *inputPtr++;
       }
-
-      if (!(inputPtr < inputEndPtr && outputPtr < outputEndPtr)) {
-        break;
-      }
     }
   }
 
-  *dst = uncompressedData.release();
   return uncompressedLen;
 }
@@ -0,0 +1,453 @@
+#include "athena/BatchFileLoader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "athena/FileReader.hpp"
+
+#if __linux__ && __has_include(<linux/io_uring.h>)
+#define ATHENA_IO_URING 1
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace athena::io {
+#if ATHENA_IO_URING
+namespace {
+enum RingOp : atUint64 { RingOpen, RingStat, RingRead, RingClose };
+
+constexpr atUint64 MaxRingRead = 0x40000000;
+// Never a valid (slot << 2) | op, so cancellations can be told apart from the requests they target
+constexpr atUint64 RingCancelTag = ~atUint64(0);
+
+template <typename T>
+T loadAcquire(T* ptr) {
+  return std::atomic_ref<T>(*ptr).load(std::memory_order_acquire);
+}
+
+template <typename T>
+void storeRelease(T* ptr, T val) {
+  std::atomic_ref<T>(*ptr).store(val, std::memory_order_release);
+}
+} // Anonymous namespace
+
+struct BatchFileLoader::Ring {
+  int fd = -1;
+  void* sqRing = MAP_FAILED;
+  size_t sqRingSize = 0;
+  void* cqRing = MAP_FAILED;
+  size_t cqRingSize = 0;
+  io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqesSize = 0;
+
+  unsigned* sqTail = nullptr;
+  unsigned* sqMask = nullptr;
+  unsigned* sqArray = nullptr;
+  unsigned sqEntries = 0;
+  unsigned* cqHead = nullptr;
+  unsigned* cqTail = nullptr;
+  unsigned* cqMask = nullptr;
+  io_uring_cqe* cqes = nullptr;
+  unsigned toSubmit = 0;
+  unsigned inFlight = 0; // submitted, but not yet reaped
+
+  /* One file being loaded; a slot is reused once its file has been closed */
+  struct Job {
+    size_t index = 0;
+    int fileFd = -1;
+    int pending = 0;
+    bool failed = false;
+    struct statx stx = {};
+    std::unique_ptr<atUint8[]> data;
+    atUint64 size = 0;
+    atUint64 done = 0;
+  };
+
+  ~Ring() {
+    if (sqes != MAP_FAILED)
+      munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED)
+      munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED)
+      munmap(sqRing, sqRingSize);
+    if (fd >= 0)
+      ::close(fd);
+  }
+
+  bool init(atUint32 depth) {
+    io_uring_params p = {};
+    fd = int(syscall(__NR_io_uring_setup, depth, &p));
+    if (fd < 0)
+      return false;
+
+    sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    sqes = static_cast<io_uring_sqe*>(
+        mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqes == MAP_FAILED)
+      return false;
+
+    auto* sq = static_cast<atUint8*>(sqRing);
+    sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    sqEntries = p.sq_entries;
+    auto* cq = static_cast<atUint8*>(cqRing);
+    cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+    // Every opcode used here arrived in 5.6; older kernels get the thread pool instead
+    constexpr unsigned ProbeOps = 256;
+    std::unique_ptr<atUint8[]> probeBuf(new atUint8[sizeof(io_uring_probe) + ProbeOps * sizeof(io_uring_probe_op)]());
+    auto* probe = reinterpret_cast<io_uring_probe*>(probeBuf.get());
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, ProbeOps) < 0)
+      return false;
+    for (atUint8 op : {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE, IORING_OP_ASYNC_CANCEL}) {
+      if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+        return false;
+    }
+
+    return true;
+  }
+
+  io_uring_sqe* nextSqe(size_t slot, RingOp op) {
+    unsigned tail = *sqTail;
+    unsigned idx = tail & *sqMask;
+    io_uring_sqe* sqe = &sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = (atUint64(slot) << 2) | op;
+    sqArray[idx] = idx;
+    storeRelease(sqTail, tail + 1);
+    ++toSubmit;
+    return sqe;
+  }
+
+  void queueOpen(size_t slot, const std::string& path) {
+    io_uring_sqe* sqe = nextSqe(slot, RingOpen);
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = atUint64(path.c_str());
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+  }
+
+  void queueStat(size_t slot, const std::string& path, struct statx* stx) {
+    io_uring_sqe* sqe = nextSqe(slot, RingStat);
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = atUint64(path.c_str());
+    sqe->len = STATX_SIZE;
+    sqe->off = atUint64(stx);
+  }
+
+  void queueRead(size_t slot, Job& job) {
+    io_uring_sqe* sqe = nextSqe(slot, RingRead);
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = job.fileFd;
+    sqe->addr = atUint64(job.data.get() + job.done);
+    sqe->len = unsigned(std::min(job.size - job.done, MaxRingRead));
+    sqe->off = job.done;
+  }
+
+  void queueClose(size_t slot, int fileFd) {
+    io_uring_sqe* sqe = nextSqe(slot, RingClose);
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = fileFd;
+  }
+
+  void queueCancel(size_t slot, RingOp op) {
+    io_uring_sqe* sqe = nextSqe(0, RingOpen);
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = (atUint64(slot) << 2) | op;
+    sqe->user_data = RingCancelTag;
+  }
+
+  /* Takes back everything queued that the kernel hasn't picked up yet */
+  void dropQueued() {
+    storeRelease(sqTail, *sqTail - toSubmit);
+    toSubmit = 0;
+  }
+
+  /* Submits everything queued and waits for at least one completion */
+  bool submitAndWait() {
+    unsigned submit = toSubmit;
+    for (;;) {
+      int ret = int(syscall(__NR_io_uring_enter, fd, submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+      if (ret >= 0) {
+        toSubmit -= unsigned(ret);
+        inFlight += unsigned(ret);
+        return true;
+      }
+      if (errno == EINTR)
+        continue;
+      // Out of resources for now; wait for something in flight to complete and free some up instead
+      if ((errno == EAGAIN || errno == EBUSY) && submit && inFlight) {
+        submit = 0;
+        continue;
+      }
+      return false;
+    }
+  }
+};
+
+void BatchFileLoader::_loadRing(const std::vector<std::string>& paths, const Callback& callback) {
+  Ring& ring = *m_ring;
+
+  // Each file has at most two operations in flight (open + stat), so this never overfills either queue
+  std::vector<Ring::Job> jobs(std::max(ring.sqEntries / 2, 1u));
+  std::vector<size_t> freeSlots;
+  for (size_t i = jobs.size(); i > 0; --i)
+    freeSlots.push_back(i - 1);
+
+  size_t next = 0;
+  size_t active = 0;
+
+  auto finish = [&](size_t slot) {
+    Ring::Job& job = jobs[slot];
+    if (job.fileFd >= 0) {
+      ring.queueClose(slot, job.fileFd);
+      job.fileFd = -1;
+      return;
+    }
+    job = Ring::Job();
+    freeSlots.push_back(slot);
+    --active;
+  };
+
+  auto fail = [&](size_t slot, bool opened) {
+    Ring::Job& job = jobs[slot];
+    if (m_globalErr) {
+      if (!opened)
+        atError(FMT_STRING("File not found '{}'"), paths[job.index]);
+      else
+        atError(FMT_STRING("Unable to read from file '{}'"), paths[job.index]);
+    }
+    callback(job.index, nullptr);
+    finish(slot);
+  };
+
+  // Cancels whatever the kernel still has in flight and waits for all of it, so nothing writes into jobs afterwards
+  auto drain = [&]() {
+    ring.dropQueued();
+    for (size_t slot = 0; slot < jobs.size(); ++slot) {
+      if (jobs[slot].pending) {
+        ring.queueCancel(slot, RingOpen);
+        ring.queueCancel(slot, RingStat);
+      } else if (jobs[slot].data) {
+        ring.queueCancel(slot, RingRead);
+      }
+    }
+
+    while (ring.inFlight || ring.toSubmit) {
+      if (!ring.submitAndWait())
+        return false;
+      unsigned head = *ring.cqHead;
+      unsigned tail = loadAcquire(ring.cqTail);
+      for (; head != tail; ++head, --ring.inFlight) {
+        const io_uring_cqe& cqe = ring.cqes[head & *ring.cqMask];
+        // An open that won the race with its cancellation still has to be closed
+        if (cqe.user_data != RingCancelTag && RingOp(cqe.user_data & 3) == RingOpen && cqe.res >= 0)
+          jobs[size_t(cqe.user_data >> 2)].fileFd = cqe.res;
+      }
+      storeRelease(ring.cqHead, head);
+    }
+    return true;
+  };
+
+  while (next < paths.size() || active > 0) {
+    while (next < paths.size() && !freeSlots.empty()) {
+      size_t slot = freeSlots.back();
+      freeSlots.pop_back();
+      Ring::Job& job = jobs[slot];
+      job.index = next++;
+      job.pending = 2;
+      ring.queueOpen(slot, paths[job.index]);
+      ring.queueStat(slot, paths[job.index], &job.stx);
+      ++active;
+    }
+
+    if (!ring.submitAndWait()) {
+      // The ring itself is broken; let the thread pool finish the job from here on
+      if (m_globalErr)
+        atError(FMT_STRING("io_uring_enter failed, falling back to threaded loading"));
+      const bool drained = drain();
+      std::vector<std::string> rest;
+      std::vector<size_t> restIndex;
+      for (Ring::Job& job : jobs) {
+        if (job.pending || job.data) {
+          rest.push_back(paths[job.index]);
+          restIndex.push_back(job.index);
+        }
+        if (job.fileFd >= 0)
+          ::close(job.fileFd);
+      }
+      if (!drained) {
+        // Reads and stats may still land in the jobs' buffers, so none of them can be freed
+        new std::vector<Ring::Job>(std::move(jobs));
+      }
+      for (; next < paths.size(); ++next) {
+        rest.push_back(paths[next]);
+        restIndex.push_back(next);
+      }
+      m_ring.reset();
+      _loadThreaded(rest, [&](size_t index, std::unique_ptr<MemoryReader> reader) {
+        callback(restIndex[index], std::move(reader));
+      });
+      return;
+    }
+
+    unsigned head = *ring.cqHead;
+    unsigned tail = loadAcquire(ring.cqTail);
+    for (; head != tail; ++head, --ring.inFlight) {
+      const io_uring_cqe& cqe = ring.cqes[head & *ring.cqMask];
+      size_t slot = size_t(cqe.user_data >> 2);
+      RingOp op = RingOp(cqe.user_data & 3);
+      int res = cqe.res;
+      Ring::Job& job = jobs[slot];
+
+      switch (op) {
+      case RingOpen:
+      case RingStat:
+        if (res < 0)
+          job.failed = true;
+        else if (op == RingOpen)
+          job.fileFd = res;
+        if (--job.pending > 0)
+          break;
+
+        if (job.failed) {
+          fail(slot, job.fileFd >= 0);
+          break;
+        }
+
+        job.size = job.stx.stx_size;
+        job.data.reset(new atUint8[job.size]);
+        if (job.size == 0) {
+          callback(job.index, std::make_unique<MemoryReader>(job.data.release(), 0, true, m_globalErr));
+          finish(slot);
+        } else {
+          ring.queueRead(slot, job);
+        }
+        break;
+
+      case RingRead:
+        if (res < 0) {
+          job.data.reset();
+          fail(slot, true);
+          break;
+        }
+
+        job.done += atUint64(res);
+        if (res > 0 && job.done < job.size) {
+          ring.queueRead(slot, job);
+          break;
+        }
+
+        // A file that shrank since the stat is delivered with what was actually there
+        callback(job.index, std::make_unique<MemoryReader>(job.data.release(), job.done, true, m_globalErr));
+        finish(slot);
+        break;
+
+      case RingClose:
+        finish(slot);
+        break;
+      }
+    }
+    storeRelease(ring.cqHead, head);
+  }
+}
+#else
+struct BatchFileLoader::Ring {};
+
+void BatchFileLoader::_loadRing(const std::vector<std::string>& paths, const Callback& callback) {
+  _loadThreaded(paths, callback);
+}
+#endif
+
+BatchFileLoader::BatchFileLoader(atUint32 queueDepth, atUint32 threadCount, bool globalErr)
+: m_threadCount(threadCount), m_globalErr(globalErr) {
+#if ATHENA_IO_URING
+  auto ring = std::make_unique<Ring>();
+  if (ring->init(std::max(queueDepth, 2u)))
+    m_ring = std::move(ring);
+#else
+  (void)queueDepth;
+#endif
+
+  if (m_threadCount == 0)
+    m_threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+BatchFileLoader::~BatchFileLoader() = default;
+
+void BatchFileLoader::load(const std::vector<std::string>& paths, const Callback& callback) {
+  if (m_ring)
+    _loadRing(paths, callback);
+  else
+    _loadThreaded(paths, callback);
+}
+
+void BatchFileLoader::_loadThreaded(const std::vector<std::string>& paths, const Callback& callback) {
+  std::atomic<size_t> next = 0;
+  std::mutex lock;
+  std::condition_variable cv;
+  std::deque<std::pair<size_t, std::unique_ptr<MemoryReader>>> ready;
+
+  auto worker = [&]() {
+    for (size_t i = next++; i < paths.size(); i = next++) {
+      std::unique_ptr<MemoryReader> reader;
+      FileReader file(paths[i], 0, m_globalErr);
+      if (file.isOpen()) {
+        atUint64 length = file.length();
+        std::unique_ptr<atUint8[]> data(new atUint8[length]);
+        atUint64 got = file.readUBytesToBuf(data.get(), length);
+        if (got == length) {
+          reader = std::make_unique<MemoryReader>(data.release(), length, true, m_globalErr);
+        } else if (m_globalErr) {
+          atError(FMT_STRING("Unable to read from file '{}'"), paths[i]);
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lk(lock);
+        ready.emplace_back(i, std::move(reader));
+      }
+      cv.notify_one();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  size_t threadCount = std::min<size_t>(m_threadCount, paths.size());
+  threads.reserve(threadCount);
+  for (size_t i = 0; i < threadCount; ++i)
+    threads.emplace_back(worker);
+
+  // Callbacks run here rather than on the workers so callers don't need to be thread-safe
+  for (size_t delivered = 0; delivered < paths.size(); ++delivered) {
+    std::unique_lock<std::mutex> lk(lock);
+    cv.wait(lk, [&] { return !ready.empty(); });
+    auto item = std::move(ready.front());
+    ready.pop_front();
+    lk.unlock();
+    callback(item.first, std::move(item.second));
+  }
+
+  for (std::thread& t : threads)
+    t.join();
+}
+} // namespace athena::io
@@ -0,0 +1,73 @@
+#include "athena/BufferPool.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace athena::io {
+namespace {
+// Trivially destructible, so it can still be read while the thread's pool is being torn down
+thread_local BufferPool* t_pool = nullptr;
+
+unsigned classIndex(atUint64 capacity) { return unsigned(std::countr_zero(capacity)); }
+} // namespace
+
+void BufferPool::Deleter::operator()(atUint8* ptr) const {
+  if (capacity && t_pool)
+    t_pool->_release(ptr, capacity);
+  else
+    delete[] ptr;
+}
+
+BufferPool::~BufferPool() {
+  if (t_pool == this)
+    t_pool = nullptr;
+  trim();
+}
+
+BufferPool& BufferPool::local() {
+  thread_local BufferPool pool;
+  t_pool = &pool;
+  return pool;
+}
+
+BufferPool::Buffer BufferPool::acquire(atUint64 size) {
+  if (size > MaxPooledSize)
+    return Buffer(new atUint8[size], Deleter{});
+
+  const atUint64 capacity = std::bit_ceil(std::max(size, atUint64(1) << MinShift));
+  auto& list = m_free[classIndex(capacity) - MinShift];
+  if (!list.empty()) {
+    atUint8* ptr = list.back();
+    list.pop_back();
+    m_cached -= capacity;
+    return Buffer(ptr, Deleter{capacity});
+  }
+
+  return Buffer(new atUint8[capacity], Deleter{capacity});
+}
+
+void BufferPool::setMaxCached(atUint64 bytes) {
+  m_maxCached = bytes;
+  if (m_cached > m_maxCached)
+    trim();
+}
+
+void BufferPool::trim() {
+  for (auto& list : m_free) {
+    for (atUint8* ptr : list)
+      delete[] ptr;
+    list.clear();
+  }
+  m_cached = 0;
+}
+
+void BufferPool::_release(atUint8* ptr, atUint64 capacity) {
+  if (m_cached + capacity > m_maxCached) {
+    delete[] ptr;
+    return;
+  }
+
+  m_free[classIndex(capacity) - MinShift].push_back(ptr);
+  m_cached += capacity;
+}
+} // namespace athena::io
@@ -0,0 +1,156 @@
+#include "athena/ChunkedWriter.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace athena::io {
+ChunkedWriter::ChunkedWriter(atUint64 chunkSize, bool globalErr)
+: m_chunkSize(chunkSize ? chunkSize : 1), m_globalErr(globalErr) {}
+
+void ChunkedWriter::seek(atInt64 position, SeekOrigin origin) {
+  atInt64 target = 0;
+  switch (origin) {
+  case SeekOrigin::Begin:
+    target = position;
+    break;
+  case SeekOrigin::Current:
+    target = atInt64(m_position) + position;
+    break;
+  case SeekOrigin::End:
+    target = atInt64(m_length) - position;
+    break;
+  }
+
+  if (target < 0) {
+    if (m_globalErr)
+      atError(FMT_STRING("Position outside stream bounds"));
+    setError();
+    return;
+  }
+
+  if (atUint64(target) > m_length)
+    _append(nullptr, atUint64(target) - m_length);
+  m_position = atUint64(target);
+}
+
+void ChunkedWriter::writeUBytes(const atUint8* data, atUint64 length) {
+  if (!data) {
+    if (m_globalErr)
+      atError(FMT_STRING("data cannnot be NULL"));
+    setError();
+    return;
+  }
+
+  // The position never passes the end, so a write is an overwrite, an append, or one then the other
+  if (m_position < m_length) {
+    const atUint64 inside = std::min(length, m_length - m_position);
+    _overwrite(data, inside);
+    if (hasError())
+      return;
+    m_position += inside;
+    data += inside;
+    length -= inside;
+  }
+
+  _append(data, length);
+  m_position += length;
+}
+
+void ChunkedWriter::attach(const void* data, atUint64 length) {
+  if (m_position != m_length) {
+    if (m_globalErr)
+      atError(FMT_STRING("Data can only be attached at the end of the stream"));
+    setError();
+    return;
+  }
+
+  if (!length)
+    return;
+
+  m_slices.push_back({static_cast<const atUint8*>(data), length});
+  m_sliceOffsets.push_back(m_length);
+  m_sliceAttached.push_back(true);
+  m_length += length;
+  m_position = m_length;
+}
+
+void ChunkedWriter::attach(std::unique_ptr<atUint8[]> data, atUint64 length) {
+  attach(static_cast<const void*>(data.get()), length);
+  if (!hasError())
+    m_ownedAttachments.push_back(std::move(data));
+}
+
+void ChunkedWriter::copyTo(void* dst) const {
+  auto* out = static_cast<atUint8*>(dst);
+  for (const atIoSlice& slice : m_slices) {
+    memcpy(out, slice.data, slice.length);
+    out += slice.length;
+  }
+}
+
+void ChunkedWriter::clear() {
+  m_slices.clear();
+  m_sliceOffsets.clear();
+  m_sliceAttached.clear();
+  m_chunks.clear();
+  m_ownedAttachments.clear();
+  m_chunkUsed = 0;
+  m_position = 0;
+  m_length = 0;
+}
+
+void ChunkedWriter::_append(const atUint8* data, atUint64 length) {
+  while (length) {
+    if (m_chunks.empty() || m_chunkUsed == m_chunkSize) {
+      m_chunks.emplace_back(new atUint8[m_chunkSize]);
+      m_chunkUsed = 0;
+    }
+
+    atUint8* dst = m_chunks.back().get() + m_chunkUsed;
+    const atUint64 count = std::min(length, m_chunkSize - m_chunkUsed);
+    if (data) {
+      memcpy(dst, data, count);
+      data += count;
+    } else {
+      memset(dst, 0, count);
+    }
+
+    // Extend the last slice when it ends right where this piece starts
+    if (!m_slices.empty() && !m_sliceAttached.back() && m_slices.back().data + m_slices.back().length == dst) {
+      m_slices.back().length += count;
+    } else {
+      m_slices.push_back({dst, count});
+      m_sliceOffsets.push_back(m_length);
+      m_sliceAttached.push_back(false);
+    }
+
+    m_chunkUsed += count;
+    m_length += count;
+    length -= count;
+  }
+}
+
+void ChunkedWriter::_overwrite(const atUint8* data, atUint64 length) {
+  auto it = std::upper_bound(m_sliceOffsets.cbegin(), m_sliceOffsets.cend(), m_position);
+  size_t idx = size_t(it - m_sliceOffsets.cbegin()) - 1;
+  atUint64 offset = m_position;
+  while (length) {
+    if (m_sliceAttached[idx]) {
+      if (m_globalErr)
+        atError(FMT_STRING("Cannot overwrite attached data at {:08X}"), offset);
+      setError();
+      return;
+    }
+
+    const atIoSlice& slice = m_slices[idx];
+    const atUint64 inSlice = offset - m_sliceOffsets[idx];
+    const atUint64 count = std::min(length, slice.length - inSlice);
+    // Chunk slices point into our own buffers, so writing through them is fine
+    memcpy(const_cast<atUint8*>(slice.data) + inSlice, data, count);
+    data += count;
+    offset += count;
+    length -= count;
+    ++idx;
+  }
+}
+} // namespace athena::io
@@ -0,0 +1,259 @@
+#include "athena/Codec.hpp"
+#include "athena/BufferPool.hpp"
+#include "athena/Compression.hpp"
+#include "athena/IStreamWriter.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <zlib.h>
+
+namespace athena::io::Compression {
+namespace {
+atUint32 readU32Big(const atUint8* p) {
+  return atUint32(p[0]) << 24 | atUint32(p[1]) << 16 | atUint32(p[2]) << 8 | atUint32(p[3]);
+}
+atUint32 readU32Little(const atUint8* p) {
+  return atUint32(p[3]) << 24 | atUint32(p[2]) << 16 | atUint32(p[1]) << 8 | atUint32(p[0]);
+}
+
+// The Compression functions take 32-bit sizes; an output limit can be clipped, an input can't
+bool fitsU32(std::span<const atUint8> src) { return src.size() <= UINT32_MAX; }
+atUint32 clipU32(atUint64 len) { return atUint32(std::min<atUint64>(len, UINT32_MAX)); }
+
+class Yaz0Codec : public Codec {
+public:
+  static constexpr size_t HeaderSize = 16;
+
+  std::string_view name() const override { return "yaz0"; }
+
+  bool detect(std::span<const atUint8> src) const override {
+    return src.size() >= HeaderSize && !memcmp(src.data(), "Yaz0", 4);
+  }
+
+  atUint64 decodedSize(std::span<const atUint8> src) const override {
+    return detect(src) ? readU32Big(src.data() + 4) : 0;
+  }
+
+  atInt64 decode(std::span<const atUint8> src, atUint8* dst, atUint64 dstLen) const override {
+    const atUint64 size = decodedSize(src);
+    if (!detect(src) || !fitsU32(src) || dstLen < size)
+      return -1;
+    const atInt64 ret = yaz0Decode(src.data() + HeaderSize, atUint32(src.size() - HeaderSize), dst, atUint32(size));
+    return ret == atInt64(size) ? ret : -1;
+  }
+
+  atInt64 decode(std::span<const atUint8> src, IStreamWriter& writer, atUint64 size) const override {
+    if (!detect(src) || !fitsU32(src))
+      return -1;
+    if (!size)
+      size = decodedSize(src);
+    const atInt64 ret = yaz0Decode(src.data() + HeaderSize, atUint32(src.size() - HeaderSize), writer, clipU32(size));
+    return ret == atInt64(size) ? ret : -1;
+  }
+};
+
+class LZ77Codec : public Codec {
+public:
+  using Codec::decode;
+
+  std::string_view name() const override { return "lz77"; }
+
+  bool detect(std::span<const atUint8> src) const override {
+    if (src.size() < 4 || (src[0] != 0x10 && src[0] != 0x11))
+      return false;
+    // Type 0x11 data over 16 MiB stores its size in a second word; an empty input encodes as that word being 0 too
+    const bool longHeader = src[0] == 0x11 && !src[1] && !src[2] && !src[3];
+    return !longHeader || src.size() >= 8;
+  }
+
+  atUint64 decodedSize(std::span<const atUint8> src) const override {
+    return detect(src) ? lz77DecompressedSize(src.data()) : 0;
+  }
+
+  atInt64 decode(std::span<const atUint8> src, atUint8* dst, atUint64 dstLen) const override {
+    const atUint64 size = decodedSize(src);
+    if (!detect(src) || !fitsU32(src) || dstLen < size)
+      return -1;
+    if (!size)
+      return 0;
+    const atUint32 ret = decompressLZ77Into(src.data(), atUint32(src.size()), dst, atUint32(size));
+    return ret == size ? atInt64(ret) : -1;
+  }
+};
+
+class ZlibCodec : public Codec {
+public:
+  explicit ZlibCodec(bool gzip) : m_gzip(gzip) {}
+
+  std::string_view name() const override { return m_gzip ? "gzip" : "zlib"; }
+
+  bool detect(std::span<const atUint8> src) const override {
+    if (m_gzip)
+      return src.size() >= 18 && src[0] == 0x1F && src[1] == 0x8B && src[2] == Z_DEFLATED;
+
+    // Deflate with a window of at most 32 KiB, a valid header check, and no preset dictionary
+    return src.size() >= 6 && (src[0] & 0x0F) == Z_DEFLATED && (src[0] >> 4) <= 7 &&
+           (atUint32(src[0]) << 8 | src[1]) % 31 == 0 && !(src[1] & 0x20);
+  }
+
+  atUint64 decodedSize(std::span<const atUint8> src) const override {
+    // Only gzip records a size, and only modulo 2^32
+    return m_gzip && detect(src) ? readU32Little(src.data() + src.size() - 4) : 0;
+  }
+
+  atInt64 decode(std::span<const atUint8> src, atUint8* dst, atUint64 dstLen) const override {
+    return detect(src) ? _inflate(src, dst, dstLen, nullptr) : -1;
+  }
+
+  atInt64 decode(std::span<const atUint8> src, IStreamWriter& writer, atUint64 size) const override {
+    if (!detect(src))
+      return -1;
+
+    // The output never has to be held at once; it goes to the writer a buffer at a time
+    constexpr atUint64 ChunkSize = 0x10000;
+    BufferPool::Buffer buf = BufferPool::local().acquire(ChunkSize);
+    const atInt64 ret = _inflate(src, buf.get(), ChunkSize, &writer);
+    return ret < 0 || (size && atUint64(ret) != size) ? -1 : ret;
+  }
+
+private:
+  // Inflates into dst; with a writer, dst is a scratch buffer that is flushed to it whenever it fills
+  atInt64 _inflate(std::span<const atUint8> src, atUint8* dst, atUint64 dstLen, IStreamWriter* writer) const {
+    z_stream strm = {};
+    if (inflateInit2(&strm, MAX_WBITS | (m_gzip ? 16 : 0)) != Z_OK)
+      return -1;
+
+    // avail_in and avail_out are 32 bits wide, so both sides are handed over in pieces
+    constexpr atUint64 MaxPiece = 0x40000000;
+    atUint64 inLeft = src.size();
+    atUint64 outLeft = dstLen;
+    atUint64 total = 0;
+    strm.next_in = const_cast<Bytef*>(src.data());
+    strm.next_out = dst;
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+      if (!strm.avail_in && inLeft) {
+        strm.avail_in = uInt(std::min(inLeft, MaxPiece));
+        inLeft -= strm.avail_in;
+      }
+      if (!strm.avail_out && outLeft) {
+        strm.avail_out = uInt(std::min(outLeft, MaxPiece));
+        outLeft -= strm.avail_out;
+      }
+
+      const uInt before = strm.avail_out;
+      ret = inflate(&strm, Z_NO_FLUSH);
+      total += before - strm.avail_out;
+
+      if (writer && (ret == Z_STREAM_END || !strm.avail_out)) {
+        writer->writeUBytes(dst, atUint64(strm.next_out - dst));
+        strm.next_out = dst;
+        strm.avail_out = 0;
+        outLeft = dstLen;
+      }
+    }
+
+    // Anything but the end of the stream means corrupt or truncated data, or a full buffer (Z_BUF_ERROR)
+    inflateEnd(&strm);
+    return ret == Z_STREAM_END ? atInt64(total) : -1;
+  }
+
+  bool m_gzip;
+};
+
+#if AT_LZOKAY
+class LZOCodec : public Codec {
+public:
+  std::string_view name() const override { return "lzo"; }
+
+  // Raw LZO1X data has no header to recognize, nor a stored size
+  bool detect(std::span<const atUint8> /*src*/) const override { return false; }
+  atUint64 decodedSize(std::span<const atUint8> /*src*/) const override { return 0; }
+
+  atInt64 decode(std::span<const atUint8> src, atUint8* dst, atUint64 dstLen) const override {
+    if (src.size() > INT32_MAX)
+      return -1;
+    const atInt32 capacity = atInt32(std::min<atUint64>(dstLen, INT32_MAX));
+    atInt32 remaining = capacity;
+    if (decompressLZO(src.data(), atInt32(src.size()), dst, remaining) < 0)
+      return -1;
+    return capacity - remaining;
+  }
+
+  atInt64 decode(std::span<const atUint8> src, IStreamWriter& writer, atUint64 size) const override {
+    if (!size || !fitsU32(src))
+      return -1;
+    const atInt64 ret = decompressLZO(src.data(), atUint32(src.size()), writer, clipU32(size));
+    return ret < 0 ? -1 : ret;
+  }
+};
+#endif
+} // namespace
+
+atInt64 Codec::decode(std::span<const atUint8> src, IStreamWriter& writer, atUint64 size) const {
+  // The most any built-in format expands: an LZ77 type 0x11 token of 4 bytes and a share of its flag byte
+  // can copy up to 0x10110 bytes. Refusing sizes past that keeps a forged header from forcing a huge buffer.
+  constexpr atUint64 MaxExpansion = 0x4000;
+
+  if (!size)
+    size = decodedSize(src);
+  if (size > src.size() * MaxExpansion)
+    return -1;
+
+  BufferPool::Buffer buf = BufferPool::local().acquire(size);
+  const atInt64 ret = decode(src, buf.get(), size);
+  if (ret > 0)
+    writer.writeUBytes(buf.get(), atUint64(ret));
+  return ret;
+}
+
+CodecRegistry::CodecRegistry(bool builtins) {
+  if (!builtins)
+    return;
+
+#if AT_LZOKAY
+  add(std::make_unique<LZOCodec>());
+#endif
+  add(std::make_unique<LZ77Codec>());
+  add(std::make_unique<ZlibCodec>(false));
+  add(std::make_unique<ZlibCodec>(true));
+  add(std::make_unique<Yaz0Codec>());
+}
+
+const CodecRegistry& CodecRegistry::defaults() {
+  static const CodecRegistry registry;
+  return registry;
+}
+
+void CodecRegistry::add(std::unique_ptr<Codec> codec) { m_codecs.insert(m_codecs.begin(), std::move(codec)); }
+
+const Codec* CodecRegistry::find(std::string_view name) const {
+  for (const auto& codec : m_codecs)
+    if (codec->name() == name)
+      return codec.get();
+  return nullptr;
+}
+
+const Codec* CodecRegistry::detect(std::span<const atUint8> src) const {
+  for (const auto& codec : m_codecs)
+    if (codec->detect(src))
+      return codec.get();
+  return nullptr;
+}
+
+atUint64 CodecRegistry::decodedSize(std::span<const atUint8> src) const {
+  const Codec* codec = detect(src);
+  return codec ? codec->decodedSize(src) : 0;
+}
+
+atInt64 CodecRegistry::decode(std::span<const atUint8> src, atUint8* dst, atUint64 dstLen) const {
+  const Codec* codec = detect(src);
+  return codec ? codec->decode(src, dst, dstLen) : -1;
+}
+
+atInt64 CodecRegistry::decode(std::span<const atUint8> src, IStreamWriter& writer, atUint64 decodedSize) const {
+  const Codec* codec = detect(src);
+  return codec ? codec->decode(src, writer, decodedSize) : -1;
+}
+} // namespace athena::io::Compression
@@ -1,8 +1,14 @@
 #include "athena/Compression.hpp"
+#include "athena/IStreamWriter.hpp"
+#include "athena/BufferPool.hpp"
 
-#if AT_LZOKAY
-#include <lzokay.hpp>
-#endif
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numbers>
 
 #include <zlib.h>
 #include "LZ77/LZType10.hpp"
@@ -21,8 +27,8 @@ atInt32 decompressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint
   strm.opaque = Z_NULL;
 
   atInt32 ret;
-  // 15 window bits, and the | 16 tells zlib to to detect if using gzip or zlib
-  ret = inflateInit2(&strm, MAX_WBITS | 16);
+  // 15 window bits, and the | 32 tells zlib to detect if using gzip or zlib
+  ret = inflateInit2(&strm, MAX_WBITS | 32);
 
   if (ret == Z_OK) {
     ret = inflate(&strm, Z_FINISH);
@@ -34,7 +40,7 @@ atInt32 decompressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint
   return ret;
 }
 
-atInt32 compressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen) {
+atInt32 compressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen, atInt32 level) {
   z_stream strm = {};
   strm.total_in = strm.avail_in = srcLen;
   strm.total_out = strm.avail_out = dstLen;
@@ -48,7 +54,7 @@ atInt32 compressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32
   atInt32 err = -1;
   atInt32 ret = -1;
 
-  err = deflateInit(&strm, Z_BEST_COMPRESSION);
+  err = deflateInit(&strm, level);
 
   if (err == Z_OK) {
     err = deflate(&strm, Z_FINISH);
@@ -69,69 +75,314 @@ atInt32 compressZlib(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32
   return ret;
 }
 
+float estimateCompressibility(const atUint8* src, atUint64 srcLen) {
+  if (!srcLen)
+    return 1.f;
+
+  // Up to 4 samples of 32 KiB, spread evenly over the input; each is as long as deflate's window,
+  // so repeats as far apart as deflate can reach are found
+  constexpr atUint64 SampleSize = 0x8000;
+  constexpr atUint64 MaxSamples = 4;
+  const atUint64 sampleLen = std::min(srcLen, SampleSize);
+  const atUint64 sampleCount = std::clamp<atUint64>(srcLen / SampleSize, 1, MaxSamples);
+  const atUint64 stride = sampleCount > 1 ? (srcLen - sampleLen) / (sampleCount - 1) : 0;
+
+  std::array<atUint32, 256> counts = {};
+  std::vector<atUint64> seen(0x8000);
+  atUint64 matched = 0;
+  for (atUint64 s = 0; s < sampleCount; ++s) {
+    const atUint8* sample = src + s * stride;
+    for (atUint64 i = 0; i < sampleLen; ++i)
+      ++counts[sample[i]];
+
+    // 4-byte sequences already seen in this sample stand in for what deflate would find as matches
+    std::fill(seen.begin(), seen.end(), 0);
+    for (atUint64 i = 0; i + 4 <= sampleLen;) {
+      atUint32 v;
+      memcpy(&v, sample + i, 4);
+      atUint64& slot = seen[(v * 2654435761u) >> 17];
+      const atUint64 tagged = atUint64(v) | (atUint64(1) << 32);
+      if (slot == tagged) {
+        matched += 4;
+        i += 4;
+      } else {
+        slot = tagged;
+        ++i;
+      }
+    }
+  }
+
+  const atUint64 total = sampleLen * sampleCount;
+  double entropy = 0.0;
+  atUint32 used = 0;
+  for (atUint32 count : counts) {
+    if (count) {
+      const double p = double(count) / double(total);
+      entropy -= p * std::log2(p);
+      ++used;
+    }
+  }
+  // Small samples underestimate entropy; the Miller-Madow term corrects for that
+  entropy = std::min(8.0, entropy + (used - 1) / (2.0 * double(total) * std::numbers::ln2));
+
+  // Literals cost about their entropy, matched bytes roughly a bit each
+  const double literals = double(total - std::min(matched, total));
+  return float(std::min(1.0, (literals * entropy / 8.0 + double(total - literals) / 8.0) / double(total)));
+}
+
+bool worthCompressing(const atUint8* src, atUint64 srcLen, float maxRatio) {
+  if (estimateCompressibility(src, srcLen) <= maxRatio)
+    return true;
+
+  // The estimate can still miss structure deflate finds, so a quick level 1 deflate of a sample has the final say
+  const atUint32 sampleLen = atUint32(std::min<atUint64>(srcLen, 0x10000));
+  if (!sampleLen)
+    return false;
+  BufferPool::Buffer out = BufferPool::local().acquire(compressBound(sampleLen));
+  const atInt32 ret =
+      compressZlib(src + (srcLen - sampleLen) / 2, sampleLen, out.get(), atUint32(compressBound(sampleLen)), 1);
+  return ret > 0 && float(ret) <= float(sampleLen) * maxRatio;
+}
+
+atInt32 compressZlibIfWorthwhile(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen, atInt32 level,
+                                 float maxRatio) {
+  if (!worthCompressing(src, srcLen, maxRatio))
+    return 0;
+
+  const atInt32 ret = compressZlib(src, srcLen, dst, dstLen, level);
+  return ret > 0 && atUint32(ret) < srcLen ? ret : 0;
+}
+
 #if AT_LZOKAY
 atInt32 decompressLZO(const atUint8* source, const atInt32 sourceSize, atUint8* dst, atInt32& dstSize) {
-  size_t size = dstSize;
-  auto result = lzokay::decompress(source, sourceSize, dst, size);
+  size_t size = 0;
+  auto result = lzokay::decompress(source, sourceSize, dst, dstSize, size);
   dstSize -= (atInt32)size;
 
   return (atInt32)result;
 }
+
+atInt64 decompressLZO(const atUint8* src, atUint32 srcLen, IStreamWriter& writer, atUint32 uncompressedSize) {
+  // lzokay only decodes whole buffers, so the output goes through this thread's pooled scratch memory
+  BufferPool::Buffer buf = BufferPool::local().acquire(uncompressedSize);
+  size_t size = 0;
+  auto result = lzokay::decompress(src, srcLen, buf.get(), uncompressedSize, size);
+  // Padding after the end-of-stream marker is fine
+  if (result != lzokay::EResult::Success && result != lzokay::EResult::InputNotConsumed)
+    return atInt64(result);
+
+  writer.writeUBytes(buf.get(), size);
+  return atInt64(size);
+}
+
+struct LZOEncoder::Dictionary : lzokay::Dict<> {};
+
+LZOEncoder::LZOEncoder() : m_dict(std::make_unique<Dictionary>()) {}
+
+LZOEncoder::~LZOEncoder() = default;
+
+atInt32 LZOEncoder::encode(const atUint8* src, atUint32 srcSize, atUint8* dst, atUint32 dstSize) {
+  size_t size = 0;
+  auto result = lzokay::compress(src, srcSize, dst, dstSize, size, *m_dict);
+  if (result != lzokay::EResult::Success)
+    return atInt32(result);
+
+  return atInt32(size);
+}
+
+atInt32 compressLZO(const atUint8* src, atUint32 srcSize, atUint8* dst, atUint32 dstSize) {
+  thread_local LZOEncoder encoder;
+  return encoder.encode(src, srcSize, dst, dstSize);
+}
 #endif
 
-// src points to the yaz0 source data (to the "real" source data, not at the header!)
-// dst points to a buffer uncompressedSize bytes large (you get uncompressedSize from
-// the second 4 bytes in the Yaz0 header).
-atUint32 yaz0Decode(const atUint8* src, atUint8* dst, atUint32 uncompressedSize) {
-  atUint32 srcPlace = 0, dstPlace = 0; // current read/write positions
+namespace {
+constexpr atUint32 Yaz0MaxRun = 0xFF + 0x12;
+
+struct Yaz0DecodeState {
+  atUint32 srcPos = 0;
+  atUint8 code = 0;     // current "code" byte, next flag in the top bit
+  atUint32 bitsLeft = 0; // number of valid bits left in "code"
+};
+
+// Copies a back-reference whose source may overlap what it is writing
+inline void yaz0CopyRun(atUint8* out, atUint32 dist, atUint32 count) {
+  if (dist >= 8) {
+    // Eight bytes at a time never read anything this same copy writes
+    const atUint8* from = out - dist;
+    atUint32 i = 0;
+    for (; i + 8 <= count; i += 8)
+      memcpy(out + i, from + i, 8);
+    for (; i < count; ++i)
+      out[i] = from[i];
+  } else if (dist == 1) {
+    memset(out, out[-1], count);
+  } else if (count < 32) {
+    const atUint8* from = out - dist;
+    for (atUint32 i = 0; i < count; ++i)
+      out[i] = from[i];
+  } else {
+    // Everything from out - dist on repeats with period dist, so each copy can be as long as
+    // the largest multiple of dist already written, which doubles every round
+    atUint32 done = 0;
+    atUint32 span = dist;
+    while (done < count) {
+      atUint32 n = std::min(span, count - done);
+      memcpy(out + done, out + done - span, n);
+      done += n;
+      span = (dist + done) / dist * dist;
+    }
+  }
+}
 
-  atInt32 validBitCount = 0; // number of valid bits left in "code" byte
-  atUint8 currCodeByte;
+// Decodes into buf from pos onwards, with everything before pos available as history.
+// Groups are only started while pos < stopAt, and runs are cut off at end.
+// Returns false when the input is truncated or refers back past the start of the output.
+bool yaz0DecodeRun(const atUint8* src, atUint32 srcLen, Yaz0DecodeState& st, atUint8* buf, atUint32& pos,
+                   atUint32 stopAt, atUint32 end) {
+  atUint32 s = st.srcPos;
+  atUint8 code = st.code;
+  atUint32 bitsLeft = st.bitsLeft;
+  bool ok = true;
+
+  while (pos < stopAt) {
+    // With room for a whole group on both sides, its eight codes need no further bounds checks
+    if (bitsLeft == 0 && srcLen - s >= 25 && stopAt - pos >= 8 * Yaz0MaxRun) {
+      code = src[s++];
+      if (code == 0xFF) {
+        // Eight straight copies in a row are common in poorly compressible data
+        memcpy(buf + pos, src + s, 8);
+        s += 8;
+        pos += 8;
+        continue;
+      }
 
-  while (dstPlace < uncompressedSize) {
-    // read new "code" byte if the current one is used up
-    if (validBitCount == 0) {
-      currCodeByte = src[srcPlace];
-      ++srcPlace;
-      validBitCount = 8;
+      for (atUint32 i = 0; i < 8 && ok; ++i, code <<= 1) {
+        if (code & 0x80) {
+          buf[pos++] = src[s++];
+          continue;
+        }
+
+        atUint8 byte1 = src[s];
+        atUint8 byte2 = src[s + 1];
+        s += 2;
+        atUint32 dist = (((byte1 & 0xF) << 8) | byte2) + 1;
+        atUint32 numBytes = byte1 >> 4 ? (byte1 >> 4) + 2 : src[s++] + 0x12;
+        if (dist > pos) {
+          ok = false;
+        } else {
+          yaz0CopyRun(buf + pos, dist, numBytes);
+          pos += numBytes;
+        }
+      }
+      if (!ok)
+        break;
+      continue;
     }
 
-    if ((currCodeByte & 0x80) != 0) {
+    if (bitsLeft == 0) {
+      if (s >= srcLen) {
+        ok = false;
+        break;
+      }
+      code = src[s++];
+      bitsLeft = 8;
+    }
+
+    if (code & 0x80) {
       // straight copy
-      dst[dstPlace] = src[srcPlace];
-      dstPlace++;
-      srcPlace++;
+      if (s >= srcLen) {
+        ok = false;
+        break;
+      }
+      buf[pos++] = src[s++];
     } else {
       // RLE part
-      atUint8 byte1 = src[srcPlace];
-      atUint8 byte2 = src[srcPlace + 1];
-      srcPlace += 2;
-
-      atUint32 dist = ((byte1 & 0xF) << 8) | byte2;
-      atUint32 copySource = dstPlace - (dist + 1);
+      if (srcLen - s < 2) {
+        ok = false;
+        break;
+      }
+      atUint8 byte1 = src[s];
+      atUint8 byte2 = src[s + 1];
+      s += 2;
 
+      atUint32 dist = (((byte1 & 0xF) << 8) | byte2) + 1;
       atUint32 numBytes = byte1 >> 4;
-
       if (numBytes == 0) {
-        numBytes = src[srcPlace] + 0x12;
-        srcPlace++;
-      } else
+        if (s >= srcLen) {
+          ok = false;
+          break;
+        }
+        numBytes = src[s++] + 0x12;
+      } else {
         numBytes += 2;
+      }
 
-      // copy run
-      for (atUint32 i = 0; i < numBytes; ++i) {
-        dst[dstPlace] = dst[copySource];
-        copySource++;
-        dstPlace++;
+      if (dist > pos) {
+        ok = false;
+        break;
       }
+      numBytes = std::min(numBytes, end - pos);
+      yaz0CopyRun(buf + pos, dist, numBytes);
+      pos += numBytes;
     }
 
     // use next bit from "code" byte
-    currCodeByte <<= 1;
-    validBitCount -= 1;
+    code <<= 1;
+    --bitsLeft;
+  }
+
+  st.srcPos = s;
+  st.code = code;
+  st.bitsLeft = bitsLeft;
+  return ok;
+}
+} // namespace
+
+// src points to the yaz0 source data (to the "real" source data, not at the header!)
+// dst points to a buffer uncompressedSize bytes large (you get uncompressedSize from
+// the second 4 bytes in the Yaz0 header).
+atUint32 yaz0Decode(const atUint8* src, atUint8* dst, atUint32 uncompressedSize) {
+  // The source length is unknown here, so only the output side is checked
+  Yaz0DecodeState st;
+  atUint32 pos = 0;
+  yaz0DecodeRun(src, UINT32_MAX, st, dst, pos, uncompressedSize, uncompressedSize);
+  return pos;
+}
+
+atInt64 yaz0Decode(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen) {
+  Yaz0DecodeState st;
+  atUint32 pos = 0;
+  if (!yaz0DecodeRun(src, srcLen, st, dst, pos, dstLen, dstLen))
+    return -1;
+  return pos;
+}
+
+atInt64 yaz0Decode(const atUint8* src, atUint32 srcLen, IStreamWriter& writer, atUint32 uncompressedSize) {
+  // Output goes through a buffer that keeps the last 4 KiB as history for back-references
+  constexpr atUint32 History = 0x1000;
+  constexpr atUint32 Capacity = History + 0x10000 + Yaz0MaxRun;
+  auto buf = std::make_unique_for_overwrite<atUint8[]>(Capacity);
+
+  Yaz0DecodeState st;
+  atUint32 pos = 0;
+  atUint32 written = 0;
+  while (written < uncompressedSize) {
+    const atUint32 end = std::min<atUint64>(Capacity, atUint64(pos) + (uncompressedSize - written));
+    const atUint32 start = pos;
+    const bool ok = yaz0DecodeRun(src, srcLen, st, buf.get(), pos, std::min(end, Capacity - Yaz0MaxRun), end);
+    writer.writeUBytes(buf.get() + start, pos - start);
+    written += pos - start;
+    if (!ok)
+      return -1;
+
+    if (pos > History) {
+      memmove(buf.get(), buf.get() + pos - History, History);
+      pos = History;
+    }
   }
 
-  return dstPlace;
+  return written;
 }
 
 // Yaz0 encode
@@ -139,10 +390,25 @@ typedef struct {
   atUint32 srcPos, dstPos;
 } yaz0_Ret;
 
-atUint32 simpleEnc(const atUint8* src, atInt32 size, atInt32 pos, atUint32* pMatchPos);
-atUint32 nintendoEnc(const atUint8* src, atInt32 size, atInt32 pos, atUint32* pMatchPos);
+namespace {
+constexpr atInt32 Yaz0Window = 0x1000;
+constexpr atUint32 Yaz0MaxMatch = 0xFF + 0x12;
+constexpr atUint32 Yaz0HashBits = 14;
+
+atUint32 yaz0ChainLength(atInt32 level) {
+  level = std::clamp(level, 1, 9);
+  return level == 9 ? atUint32(Yaz0Window) : 8u << (level - 1);
+}
+} // namespace
+
+Yaz0Encoder::Yaz0Encoder(atInt32 level)
+: m_maxChain(yaz0ChainLength(level))
+, m_head(std::make_unique_for_overwrite<atInt32[]>(1 << Yaz0HashBits))
+, m_prev(std::make_unique_for_overwrite<atInt32[]>(Yaz0Window)) {}
+
+Yaz0Encoder::~Yaz0Encoder() = default;
 
-atUint32 yaz0Encode(const atUint8* src, atUint32 srcSize, atUint8* data) {
+atUint32 Yaz0Encoder::encode(const atUint8* src, atUint32 srcSize, atUint8* data) {
   yaz0_Ret r = {0, 0};
   atInt32 pos = 0;
   atUint8 dst[24]; // 8 codes * 3 bytes maximum
@@ -151,11 +417,12 @@ atUint32 yaz0Encode(const atUint8* src, atUint32 srcSize, atUint8* data) {
 
   atUint32 validBitCount = 0; // number of valid bits left in "code" byte
   atUint8 currCodeByte = 0;
+  _reset(src, srcSize);
 
   while (r.srcPos < srcSize) {
     atUint32 numBytes;
     atUint32 matchPos;
-    numBytes = nintendoEnc(src, srcSize, r.srcPos, &matchPos);
+    numBytes = _nintendoEnc(r.srcPos, &matchPos);
 
     if (numBytes < 3) {
       // straight copy
@@ -228,75 +495,117 @@ atUint32 yaz0Encode(const atUint8* src, atUint32 srcSize, atUint8* data) {
   return dstSize;
 }
 
+void Yaz0Encoder::_reset(const atUint8* src, atUint32 srcSize) {
+  m_src = src;
+  m_size = atInt32(srcSize);
+  m_inserted = 0;
+  m_numBytes1 = 0;
+  m_matchPos = 0;
+  m_prevFlag = false;
+  std::fill_n(m_head.get(), 1 << Yaz0HashBits, -1);
+}
+
+// Finds the longest earlier match for a position through hash chains over the 4 KiB window.
+// With an unlimited chain it picks the same match the old exhaustive scan did, except
+// that lengths are capped at what one code can hold.
+atUint32 Yaz0Encoder::_find(atInt32 pos, atUint32* pMatchPos) {
+  // Every position before this one has to be in the chains
+  for (; m_inserted < pos; ++m_inserted) {
+    if (m_inserted + 3 > m_size)
+      continue;
+    atUint32 h = _hash(m_inserted);
+    m_prev[m_inserted & (Yaz0Window - 1)] = m_head[h];
+    m_head[h] = m_inserted;
+  }
+
+  atUint32 numBytes = 1;
+  atUint32 matchPos = 0;
+  if (pos + 3 <= m_size) {
+    const atUint32 maxLen = std::min(atUint32(m_size - pos), Yaz0MaxMatch);
+    const atUint8* cur = m_src + pos;
+    const atInt32 startPos = pos - Yaz0Window;
+    atInt32 cand = m_head[_hash(pos)];
+    for (atUint32 chain = m_maxChain; cand >= 0 && cand >= startPos && chain; --chain) {
+      const atUint8* ref = m_src + cand;
+      // Equal lengths still win so that, as in the old scan, the oldest of the longest matches is kept
+      if (ref[numBytes - 1] == cur[numBytes - 1] && ref[0] == cur[0]) {
+        atUint32 len = 0;
+        while (len < maxLen && ref[len] == cur[len])
+          ++len;
+        if (len >= numBytes && len >= 3) {
+          numBytes = len;
+          matchPos = atUint32(cand);
+          if (len == maxLen && maxLen == Yaz0MaxMatch)
+            break;
+        }
+      }
+      cand = m_prev[cand & (Yaz0Window - 1)];
+    }
+  }
+
+  *pMatchPos = matchPos;
+  return numBytes;
+}
+
+atUint32 Yaz0Encoder::_hash(atInt32 pos) const {
+  const atUint8* p = m_src + pos;
+  atUint32 v = atUint32(p[0]) << 16 | atUint32(p[1]) << 8 | p[2];
+  return (v * 2654435761u) >> (32 - Yaz0HashBits);
+}
+
 // a lookahead encoding scheme for ngc Yaz0
-atUint32 nintendoEnc(const atUint8* src, atInt32 size, atInt32 pos, atUint32* pMatchPos) {
+atUint32 Yaz0Encoder::_nintendoEnc(atInt32 pos, atUint32* pMatchPos) {
   atUint32 numBytes = 1;
-  static atUint32 numBytes1;
-  static atUint32 matchPos;
-  static atInt32 prevFlag = 0;
 
   // if prevFlag is set, it means that the previous position was determined by look-ahead try.
   // so just use it. this is not the best optimization, but nintendo's choice for speed.
-  if (prevFlag == 1) {
-    *pMatchPos = matchPos;
-    prevFlag = 0;
-    return numBytes1;
+  if (m_prevFlag) {
+    *pMatchPos = m_matchPos;
+    m_prevFlag = false;
+    return m_numBytes1;
   }
 
-  prevFlag = 0;
-  numBytes = simpleEnc(src, size, pos, &matchPos);
-  *pMatchPos = matchPos;
+  numBytes = _find(pos, &m_matchPos);
+  *pMatchPos = m_matchPos;
 
   // if this position is RLE encoded, then compare to copying 1 byte and next position(pos+1) encoding
   if (numBytes >= 3) {
-    numBytes1 = simpleEnc(src, size, pos + 1, &matchPos);
+    m_numBytes1 = _find(pos + 1, &m_matchPos);
 
     // if the next position encoding is +2 longer than current position, choose it.
     // this does not guarantee the best optimization, but fairly good optimization with speed.
-    if (numBytes1 >= numBytes + 2) {
+    if (m_numBytes1 >= numBytes + 2) {
       numBytes = 1;
-      prevFlag = 1;
+      m_prevFlag = true;
     }
   }
 
   return numBytes;
 }
 
-// simple and straight encoding scheme for Yaz0
-atUint32 simpleEnc(const atUint8* src, atInt32 size, atInt32 pos, atUint32* pMatchPos) {
-  int startPos = pos - 0x1000, j, i;
-  atUint32 numBytes = 1;
-  atUint32 matchPos = 0;
-
-  if (startPos < 0)
-    startPos = 0;
-
-  for (i = startPos; i < pos; i++) {
-    for (j = 0; j < size - pos; j++) {
-      if (src[i + j] != src[j + pos])
-        break;
-    }
+atUint32 yaz0Encode(const atUint8* src, atUint32 srcSize, atUint8* data, atInt32 level) {
+  return Yaz0Encoder(level).encode(src, srcSize, data);
+}
 
-    if ((atUint32)j > numBytes) {
-      numBytes = j;
-      matchPos = i;
-    }
+atUint32 decompressLZ77(const atUint8* src, atUint32 srcLen, atUint8** dst) {
+  if (*src == 0x11) {
+    return LZType11().decompress(src, dst, srcLen);
   }
 
-  *pMatchPos = matchPos;
+  return LZType10(2).decompress(src, dst, srcLen);
+}
 
-  if (numBytes == 2)
-    numBytes = 1;
+atUint32 lz77DecompressedSize(const atUint8* src) { return LZBase::decompressedSize(src); }
 
-  return numBytes;
-}
+atUint32 decompressLZ77Into(const atUint8* src, atUint32 srcLen, atUint8* dst, atUint32 dstLen) {
+  if (srcLen < 4)
+    return 0;
 
-atUint32 decompressLZ77(const atUint8* src, atUint32 srcLen, atUint8** dst) {
   if (*src == 0x11) {
-    return LZType11().decompress(src, dst, srcLen);
+    return LZType11().decompressInto(src, srcLen, dst, dstLen);
   }
 
-  return LZType10(2).decompress(src, dst, srcLen);
+  return LZType10(2).decompressInto(src, srcLen, dst, dstLen);
 }
 
 atUint32 compressLZ77(const atUint8* src, atUint32 srcLen, atUint8** dst, bool extended) {
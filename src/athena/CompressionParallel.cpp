@@ -0,0 +1,156 @@
+#include "athena/Compression.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include <zlib.h>
+
+namespace athena::io::Compression {
+namespace {
+template <class Worker>
+void runWorkers(Worker& worker, size_t jobCount, atUint32 threadCount) {
+  if (threadCount == 0)
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  size_t workerCount = std::min<size_t>(threadCount, jobCount);
+  if (workerCount <= 1) {
+    worker();
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(workerCount - 1);
+  for (size_t i = 1; i < workerCount; ++i)
+    threads.emplace_back(std::ref(worker));
+  worker();
+  for (std::thread& t : threads)
+    t.join();
+}
+
+constexpr atUint64 ZlibWindowSize = atUint64(1) << MAX_WBITS;
+
+struct ZlibBlock {
+  std::vector<atUint8> data;
+  atUint32 check = 0;
+  bool ok = false;
+};
+
+// Deflates one block as raw deflate data, ending it on a byte boundary so the next block's data can follow it directly
+void deflateBlock(z_stream& strm, const atUint8* src, atUint64 begin, atUint64 end, bool last, bool gzip,
+                  ZlibBlock& block) {
+  if (deflateReset(&strm) != Z_OK)
+    return;
+
+  // Matches may reach back into the previous block, just as if the whole buffer were deflated at once
+  if (begin) {
+    const atUint64 dictLen = std::min(begin, ZlibWindowSize);
+    if (deflateSetDictionary(&strm, src + begin - dictLen, uInt(dictLen)) != Z_OK)
+      return;
+  }
+
+  const uLong len = uLong(end - begin);
+  // Z_SYNC_FLUSH appends an empty stored block: 5 bytes plus up to 1 byte of padding
+  block.data.resize(deflateBound(&strm, len) + 6);
+  strm.next_in = const_cast<Bytef*>(src + begin);
+  strm.avail_in = uInt(len);
+  strm.next_out = block.data.data();
+  strm.avail_out = uInt(block.data.size());
+  const int ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+  if (ret != (last ? Z_STREAM_END : Z_OK) || strm.avail_in)
+    return;
+
+  block.data.resize(block.data.size() - strm.avail_out);
+  block.check = gzip ? atUint32(crc32(crc32(0, nullptr, 0), src + begin, uInt(len)))
+                     : atUint32(adler32(adler32(0, nullptr, 0), src + begin, uInt(len)));
+  block.ok = true;
+}
+} // namespace
+
+std::vector<atUint8> compressZlibParallel(const atUint8* src, atUint64 srcLen, atInt32 level, atUint32 threadCount,
+                                          atUint32 blockSize, bool gzip) {
+  // Blocks are fed to zlib in one go, so each must fit in avail_in
+  const atUint64 blockLen = std::clamp<atUint64>(blockSize, ZlibWindowSize, 0x40000000);
+  const size_t blockCount = std::max<size_t>((srcLen + blockLen - 1) / blockLen, 1);
+  std::vector<ZlibBlock> blocks(blockCount);
+  std::atomic<size_t> next = 0;
+
+  // Each worker keeps one deflate state and resets it between blocks
+  auto worker = [&]() {
+    z_stream strm = {};
+    if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      return;
+    for (size_t i = next++; i < blockCount; i = next++) {
+      const atUint64 begin = i * blockLen;
+      const atUint64 end = std::min(begin + blockLen, srcLen);
+      deflateBlock(strm, src, begin, end, i == blockCount - 1, gzip, blocks[i]);
+    }
+    deflateEnd(&strm);
+  };
+  runWorkers(worker, blockCount, threadCount);
+
+  size_t total = gzip ? 18 : 6;
+  for (const ZlibBlock& block : blocks) {
+    if (!block.ok)
+      return {};
+    total += block.data.size();
+  }
+
+  std::vector<atUint8> out;
+  out.reserve(total);
+  if (gzip) {
+    // No name, no timestamp, OS unknown
+    const atUint8 extraFlags = level == 9 ? 2 : level == 1 ? 4 : 0;
+    const atUint8 header[10] = {0x1F, 0x8B, Z_DEFLATED, 0, 0, 0, 0, 0, extraFlags, 0xFF};
+    out.insert(out.end(), header, header + 10);
+  } else {
+    // The FLEVEL bits only describe the level used; decoders ignore them
+    const atUint32 flevel = level >= 0 && level <= 1 ? 0 : level >= 2 && level <= 5 ? 1 : level >= 7 ? 3 : 2;
+    atUint32 header = (0x78 << 8) | (flevel << 6);
+    header += 31 - header % 31;
+    out.push_back(atUint8(header >> 8));
+    out.push_back(atUint8(header));
+  }
+
+  // The per-block checksums are combined in order instead of running one pass over the whole input
+  atUint32 check = gzip ? atUint32(crc32(0, nullptr, 0)) : atUint32(adler32(0, nullptr, 0));
+  for (size_t i = 0; i < blockCount; ++i) {
+    const ZlibBlock& block = blocks[i];
+    out.insert(out.end(), block.data.begin(), block.data.end());
+    const z_off_t len = z_off_t(std::min((i + 1) * blockLen, srcLen) - std::min(i * blockLen, srcLen));
+    check = gzip ? atUint32(crc32_combine(check, block.check, len))
+                 : atUint32(adler32_combine(check, block.check, len));
+  }
+
+  if (gzip) {
+    for (atUint32 v : {check, atUint32(srcLen)})
+      for (int i = 0; i < 4; ++i)
+        out.push_back(atUint8(v >> (i * 8)));
+  } else {
+    for (int i = 3; i >= 0; --i)
+      out.push_back(atUint8(check >> (i * 8)));
+  }
+
+  return out;
+}
+
+std::vector<std::vector<atUint8>> yaz0EncodeBatch(const std::vector<std::span<const atUint8>>& inputs, atInt32 level,
+                                                  atUint32 threadCount) {
+  std::vector<std::vector<atUint8>> results(inputs.size());
+  std::atomic<size_t> next = 0;
+
+  // Each worker keeps one encoder, so the match tables are only allocated once per thread
+  auto worker = [&]() {
+    Yaz0Encoder encoder(level);
+    for (size_t i = next++; i < inputs.size(); i = next++) {
+      const std::span<const atUint8>& input = inputs[i];
+      std::vector<atUint8>& out = results[i];
+      out.resize(Yaz0Encoder::maxEncodedSize(atUint32(input.size())));
+      out.resize(encoder.encode(input.data(), atUint32(input.size()), out.data()));
+    }
+  };
+
+  runWorkers(worker, inputs.size(), threadCount);
+  return results;
+}
+} // namespace athena::io::Compression
@@ -0,0 +1,187 @@
+#include "athena/FileReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace athena::io {
+void FileReader::seek(atInt64 pos, SeekOrigin origin) {
+  if (!isOpen())
+    return;
+
+  // Seeks only move the logical offset; the handle is repositioned by the next read that needs it
+  atUint64 offset = m_offset;
+  switch (origin) {
+  case SeekOrigin::Begin:
+    offset = pos;
+    break;
+  case SeekOrigin::Current:
+    offset += pos;
+    break;
+  case SeekOrigin::End:
+    // Cached readers have always counted End offsets back from the end of the file
+    offset = m_blockSize > 0 ? m_fileSize - pos : m_fileSize + pos;
+    break;
+  }
+
+  if (atInt64(offset) < 0 || (m_blockSize > 0 && offset > m_fileSize)) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to seek in file"));
+    setError();
+    return;
+  }
+
+  m_offset = offset;
+}
+
+atUint64 FileReader::position() const {
+  if (!isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not open"));
+    return 0;
+  }
+
+  return m_offset;
+}
+
+atUint64 FileReader::length() const {
+  if (!isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not open"));
+    return 0;
+  }
+
+  return m_fileSize;
+}
+
+atUint64 FileReader::readUBytesToBuf(void* buf, atUint64 len) {
+  if (!isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not open for reading"));
+    setError();
+    return 0;
+  }
+
+  if (m_blockSize == 0) {
+    atUint64 ret = _readAt(m_offset, buf, len);
+    m_offset += ret;
+    return ret;
+  }
+
+  if (m_offset >= m_fileSize)
+    return 0;
+  if (len > m_fileSize - m_offset)
+    len = m_fileSize - m_offset;
+
+  atUint8* dst = reinterpret_cast<atUint8*>(buf);
+  atUint64 rem = len;
+  while (rem) {
+    atInt64 block = atInt64(m_offset / m_blockSize);
+    atUint64 cacheOffset = m_offset % m_blockSize;
+
+    // Whole blocks that aren't resident go straight to the destination instead of through the cache
+    if (cacheOffset == 0 && rem >= m_blockSize &&
+        std::none_of(m_cache.cbegin(), m_cache.cend(), [&](const CacheBlock& b) { return b.index == block; })) {
+      atUint64 direct = rem - rem % m_blockSize;
+      atUint64 ret = _readAt(m_offset, dst, direct);
+      dst += ret;
+      rem -= ret;
+      m_offset += ret;
+      if (ret != direct)
+        break;
+      continue;
+    }
+
+    const CacheBlock* cb = _fetchBlock(block);
+    if (!cb || cacheOffset >= cb->size)
+      break;
+
+    atUint64 cacheSize = std::min(rem, cb->size - cacheOffset);
+    memcpy(dst, cb->data.get() + cacheOffset, cacheSize);
+    dst += cacheSize;
+    rem -= cacheSize;
+    m_offset += cacheSize;
+  }
+
+  return atUint64(dst - reinterpret_cast<atUint8*>(buf));
+}
+
+void FileReader::setCacheSize(atInt32 blockSize, atUint32 blockCount) {
+  // Not clamped to the file size; the file may grow, and _fetchBlock only allocates what it reads
+  m_blockSize = blockSize > 0 ? atUint64(blockSize) : 0;
+
+  m_cache.clear();
+  if (m_blockSize > 0)
+    m_cache.resize(std::max(blockCount, 1u));
+}
+
+void FileReader::refreshLength() {
+  if (!isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not open"));
+    setError();
+    return;
+  }
+
+  m_fileSize = _queryLength();
+  _invalidateCache();
+}
+
+atUint64 FileReader::_readAt(atUint64 offset, void* buf, atUint64 len) {
+  atUint64 got;
+  if (!_rawReadAt(offset, buf, len, got)) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to seek in file"));
+    setError();
+  }
+  return got;
+}
+
+std::span<const atUint8> FileReader::_contiguousSpan(atUint64 length) {
+  if (!isOpen() || m_blockSize == 0 || m_offset >= m_fileSize)
+    return {};
+
+  // Only a range inside a single cache block can be handed out directly
+  atUint64 cacheOffset = m_offset % m_blockSize;
+  if (cacheOffset + length > m_blockSize)
+    return {};
+
+  const CacheBlock* cb = _fetchBlock(atInt64(m_offset / m_blockSize));
+  if (!cb || cacheOffset >= cb->size)
+    return {};
+  return {cb->data.get() + cacheOffset, size_t(std::min(length, cb->size - cacheOffset))};
+}
+
+const FileReader::CacheBlock* FileReader::_fetchBlock(atInt64 index) {
+  CacheBlock* victim = nullptr;
+  for (CacheBlock& b : m_cache) {
+    if (b.index == index) {
+      b.lastUse = ++m_useCounter;
+      return &b;
+    }
+    if (!victim || b.lastUse < victim->lastUse)
+      victim = &b;
+  }
+
+  if (!victim)
+    return nullptr;
+
+  atUint64 start = atUint64(index) * m_blockSize;
+  atUint64 want = start < m_fileSize ? std::min(m_blockSize, m_fileSize - start) : 0;
+  if (victim->capacity < want) {
+    victim->data.reset(new atUint8[want]);
+    victim->capacity = want;
+  }
+  victim->size = _readAt(start, victim->data.get(), want);
+  victim->index = index;
+  victim->lastUse = ++m_useCounter;
+  return victim;
+}
+
+void FileReader::_invalidateCache() {
+  for (CacheBlock& b : m_cache) {
+    b.index = -1;
+    b.size = 0;
+    b.lastUse = 0;
+  }
+}
+} // namespace athena::io
@@ -3,14 +3,14 @@
 
 namespace athena::io {
 FileReader::FileReader(std::string_view filename, atInt32 cacheSize, bool globalErr)
-: m_fileHandle(nullptr), m_cacheData(nullptr), m_offset(0), m_globalErr(globalErr) {
+: m_fileHandle(nullptr), m_globalErr(globalErr) {
   m_filename = utility::utf8ToWide(filename);
   open();
   setCacheSize(cacheSize);
 }
 
 FileReader::FileReader(std::wstring_view filename, atInt32 cacheSize, bool globalErr)
-: m_fileHandle(nullptr), m_cacheData(nullptr), m_offset(0), m_globalErr(globalErr) {
+: m_fileHandle(nullptr), m_globalErr(globalErr) {
   m_filename = filename;
   open();
   setCacheSize(cacheSize);
@@ -41,6 +41,11 @@ void FileReader::open() {
     return;
   }
 
+  m_offset = 0;
+  m_rawOffset = 0;
+  m_fileSize = _queryLength();
+  _invalidateCache();
+
   // reset error
   m_hasError = false;
 }
@@ -55,144 +60,41 @@ void FileReader::close() {
 
   CloseHandle(m_fileHandle);
   m_fileHandle = 0;
+  _invalidateCache();
   return;
 }
 
-void FileReader::seek(atInt64 pos, SeekOrigin origin) {
-  if (!isOpen())
-    return;
-
-  // check block position
-  if (m_blockSize > 0) {
-    atUint64 oldOff = m_offset;
-    switch (origin) {
-    case SeekOrigin::Begin:
-      m_offset = pos;
-      break;
-    case SeekOrigin::Current:
-      m_offset += pos;
-      break;
-    case SeekOrigin::End:
-      m_offset = length() - pos;
-      break;
-    }
-    if (m_offset > length()) {
-      oldOff = m_offset;
-      if (m_globalErr)
-        atError(FMT_STRING("Unable to seek in file"));
-      setError();
-      return;
-    }
-
-    size_t block = m_offset / m_blockSize;
-    if (block != m_curBlock) {
-      LARGE_INTEGER li;
-      li.QuadPart = block * m_blockSize;
-      SetFilePointerEx(m_fileHandle, li, nullptr, FILE_BEGIN);
-      DWORD readSz;
-      ReadFile(m_fileHandle, m_cacheData.get(), m_blockSize, &readSz, nullptr);
-      m_curBlock = (atInt32)block;
-    }
-  } else {
+bool FileReader::_rawReadAt(atUint64 offset, void* buf, atUint64 len, atUint64& got) {
+  got = 0;
+  if (offset != m_rawOffset) {
     LARGE_INTEGER li;
-    li.QuadPart = pos;
-    if (!SetFilePointerEx(m_fileHandle, li, nullptr, DWORD(origin))) {
-      if (m_globalErr)
-        atError(FMT_STRING("Unable to seek in file"));
-      setError();
-    }
+    li.QuadPart = offset;
+    if (!SetFilePointerEx(m_fileHandle, li, nullptr, FILE_BEGIN))
+      return false;
+    m_rawOffset = offset;
   }
-}
 
-atUint64 FileReader::position() const {
-  if (!isOpen()) {
-    if (m_globalErr)
-      atError(FMT_STRING("File not open"));
-    return 0;
+  atUint8* dst = reinterpret_cast<atUint8*>(buf);
+  atUint64 rem = len;
+  while (rem) {
+    DWORD readSz = 0;
+    DWORD toRead = rem > 0x80000000 ? 0x80000000 : DWORD(rem);
+    if (!ReadFile(m_fileHandle, dst, toRead, &readSz, nullptr) || readSz == 0)
+      break;
+    dst += readSz;
+    rem -= readSz;
   }
 
-  if (m_blockSize > 0)
-    return m_offset;
-  else {
-    LARGE_INTEGER li = {};
-    LARGE_INTEGER res;
-    SetFilePointerEx(m_fileHandle, li, &res, FILE_CURRENT);
-    return res.QuadPart;
-  }
+  got = len - rem;
+  m_rawOffset += got;
+  return true;
 }
 
-atUint64 FileReader::length() const {
-  if (!isOpen()) {
-    if (m_globalErr)
-      atError(FMT_STRING("File not open"));
-    return 0;
-  }
-
+atUint64 FileReader::_queryLength() const {
   LARGE_INTEGER res;
-  GetFileSizeEx(m_fileHandle, &res);
-  return res.QuadPart;
-}
-
-atUint64 FileReader::readUBytesToBuf(void* buf, atUint64 len) {
-  if (!isOpen()) {
-    if (m_globalErr)
-      atError(FMT_STRING("File not open for reading"));
-    setError();
+  if (!GetFileSizeEx(m_fileHandle, &res))
     return 0;
-  }
-
-  if (m_blockSize <= 0) {
-    DWORD ret = 0;
-    ReadFile(m_fileHandle, buf, len, &ret, nullptr);
-    return ret;
-  } else {
-    LARGE_INTEGER fs;
-    GetFileSizeEx(m_fileHandle, &fs);
-    if (m_offset >= atUint64(fs.QuadPart))
-      return 0;
-    if (m_offset + len >= atUint64(fs.QuadPart))
-      len = fs.QuadPart - m_offset;
-
-    size_t block = m_offset / m_blockSize;
-    atUint64 cacheOffset = m_offset % m_blockSize;
-    atUint64 cacheSize;
-    atUint64 rem = len;
-    atUint8* dst = (atUint8*)buf;
-
-    while (rem) {
-      if (block != m_curBlock) {
-        LARGE_INTEGER li;
-        li.QuadPart = block * m_blockSize;
-        SetFilePointerEx(m_fileHandle, li, nullptr, FILE_BEGIN);
-        DWORD readSz;
-        ReadFile(m_fileHandle, m_cacheData.get(), m_blockSize, &readSz, nullptr);
-        m_curBlock = (atInt32)block;
-      }
-
-      cacheSize = rem;
-      if (cacheSize + cacheOffset > m_blockSize)
-        cacheSize = m_blockSize - cacheOffset;
-
-      memmove(dst, m_cacheData.get() + cacheOffset, cacheSize);
-      dst += cacheSize;
-      rem -= cacheSize;
-      cacheOffset = 0;
-      ++block;
-    }
-    m_offset += len;
-    return dst - (atUint8*)buf;
-  }
-}
-
-void FileReader::setCacheSize(const atInt32 blockSize) {
-  m_blockSize = blockSize;
-
-  if (m_blockSize > length())
-    m_blockSize = (atInt32)length();
-
-  m_curBlock = -1;
-  if (m_blockSize > 0)
-    m_cacheData.reset(new atUint8[m_blockSize]);
+  return res.QuadPart;
 }
 
 } // namespace athena::io
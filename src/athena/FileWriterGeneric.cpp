@@ -1,9 +1,162 @@
 #include "athena/FileWriter.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 namespace athena::io {
+void FileWriter::seek(atInt64 pos, SeekOrigin origin) {
+  if (!isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to seek in file, not open"));
+    setError();
+    return;
+  }
+
+  // Only the tracked position moves; the buffer is kept as long as later writes land inside it
+  atInt64 position = 0;
+  switch (origin) {
+  case SeekOrigin::Begin:
+    position = pos;
+    break;
+  case SeekOrigin::Current:
+    position = atInt64(m_position) + pos;
+    break;
+  case SeekOrigin::End:
+    position = atInt64(m_length) + pos;
+    break;
+  }
+
+  if (position < 0) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to seek in file"));
+    setError();
+    return;
+  }
+
+  m_position = atUint64(position);
+}
+
+void FileWriter::writeUBytes(const atUint8* data, atUint64 len) {
+  if (!isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not open for writing"));
+    setError();
+    return;
+  }
+
+  if (len == 0)
+    return;
+
+  // Writes that don't continue or overlap the buffered range can't be combined with it
+  if (m_bufferLength && (m_position < m_bufferOffset || m_position > m_bufferOffset + m_bufferLength))
+    flush();
+
+  if (!m_bufferLength)
+    m_bufferOffset = m_position;
+
+  const atUint64 bufPos = m_position - m_bufferOffset;
+  if (bufPos + len <= m_bufferSize) {
+    if (!m_buffer)
+      m_buffer.reset(new atUint8[m_bufferSize]);
+    memcpy(m_buffer.get() + bufPos, data, len);
+    m_bufferLength = std::max(m_bufferLength, bufPos + len);
+  } else if (bufPos == m_bufferLength) {
+    // Appending past the end of the buffer; send both out in one go
+    const atIoSlice slices[] = {{m_buffer.get(), m_bufferLength}, {data, len}};
+    const bool hasBuffered = m_bufferLength != 0;
+    bool ok = _writeAt(m_bufferOffset, hasBuffered ? slices : slices + 1, hasBuffered ? 2 : 1);
+    m_bufferLength = 0;
+    if (!ok) {
+      if (m_globalErr)
+        atError(FMT_STRING("Unable to write to stream"));
+      setError();
+      return;
+    }
+  } else {
+    // Overwrites part of the buffer and runs past it; keep the order of writes intact
+    flush();
+    const atIoSlice slice = {data, len};
+    if (!_writeAt(m_position, &slice, 1)) {
+      if (m_globalErr)
+        atError(FMT_STRING("Unable to write to stream"));
+      setError();
+      return;
+    }
+  }
+
+  m_position += len;
+  m_length = std::max(m_length, m_position);
+}
+
+void FileWriter::writeUBytesV(const atIoSlice* slices, size_t count) {
+  if (!isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not open for writing"));
+    setError();
+    return;
+  }
+
+  atUint64 total = 0;
+  for (size_t i = 0; i < count; ++i)
+    total += slices[i].length;
+
+  // Small batches are cheaper to gather in the buffer
+  if (total <= m_bufferSize) {
+    for (size_t i = 0; i < count; ++i)
+      writeUBytes(slices[i].data, slices[i].length);
+    return;
+  }
+
+  // Otherwise send the buffer and every slice out together, as long as they line up
+  if (m_bufferLength && m_position != m_bufferOffset + m_bufferLength)
+    flush();
+
+  std::vector<atIoSlice> all;
+  all.reserve(count + 1);
+  const atUint64 offset = m_bufferLength ? m_bufferOffset : m_position;
+  if (m_bufferLength)
+    all.push_back({m_buffer.get(), m_bufferLength});
+  all.insert(all.end(), slices, slices + count);
+  m_bufferLength = 0;
+
+  if (!_writeAt(offset, all.data(), all.size())) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to write to stream"));
+    setError();
+    return;
+  }
+
+  m_position += total;
+  m_length = std::max(m_length, m_position);
+}
+
+void FileWriter::flush() {
+  if (!m_bufferLength)
+    return;
+
+  const atIoSlice slice = {m_buffer.get(), m_bufferLength};
+  m_bufferLength = 0;
+  if (!_writeAt(m_bufferOffset, &slice, 1)) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to write to stream"));
+    setError();
+  }
+}
+
+void FileWriter::setBufferSize(atUint64 size) {
+  flush();
+  m_buffer.reset();
+  m_bufferSize = size;
+}
+
 void TransactionalFileWriter::seek(atInt64 pos, SeekOrigin origin) {
+  if (m_spill) {
+    if (origin != SeekOrigin::End)
+      m_spill->seek(pos, origin);
+    return;
+  }
+
   switch (origin) {
   case SeekOrigin::Begin:
     m_position = pos;
@@ -17,6 +170,13 @@ void TransactionalFileWriter::seek(atInt64 pos, SeekOrigin origin) {
 }
 
 void TransactionalFileWriter::writeUBytes(const atUint8* data, atUint64 len) {
+  if (m_spill) {
+    m_spill->writeUBytes(data, len);
+    if (m_spill->hasError())
+      setError();
+    return;
+  }
+
   atUint64 neededSz = m_position + len;
   if (neededSz > m_deferredBuffer.size()) {
     m_deferredBuffer.reserve(neededSz * 2);
@@ -25,5 +185,28 @@ void TransactionalFileWriter::writeUBytes(const atUint8* data, atUint64 len) {
 
   memmove(m_deferredBuffer.data() + m_position, data, len);
   m_position += len;
+
+  if (m_spillThreshold && m_overwrite && m_deferredBuffer.size() > m_spillThreshold)
+    _spill();
+}
+
+void TransactionalFileWriter::_spill() {
+  // The same temporary file flush() would have produced, just opened early
+  m_spill = std::make_unique<FileWriter>(m_filename, true, m_globalErr);
+  if (!m_spill->isOpen()) {
+    // Keep going in memory; flush() will report the problem again if it persists
+    m_spill.reset();
+    m_spillThreshold = 0;
+    return;
+  }
+
+  m_spill->writeUBytes(m_deferredBuffer.data(), m_deferredBuffer.size());
+  m_spill->seek(m_position, SeekOrigin::Begin);
+  if (m_spill->hasError())
+    setError();
+
+  m_deferredBuffer.clear();
+  m_deferredBuffer.shrink_to_fit();
+  m_position = 0;
 }
 } // namespace athena::io
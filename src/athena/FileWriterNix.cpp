@@ -7,8 +7,17 @@
 #include "osx_largefilewrapper.h"
 #endif
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+#include <sys/stat.h>
 #include <unistd.h>
 
+#if !defined(GEKKO) && !defined(__SWITCH__)
+#include <sys/uio.h>
+#endif
+
 namespace athena::io {
 FileWriter::FileWriter(std::string_view filename, bool overwrite, bool globalErr)
 : m_fileHandle(nullptr), m_globalErr(globalErr) {
@@ -54,6 +63,16 @@ void FileWriter::open(bool overwrite) {
     return;
   }
 
+#if defined(GEKKO) || defined(__SWITCH__)
+  // Writes are already combined in m_buffer; stdio's own buffer would only add a copy
+  setvbuf(m_fileHandle, nullptr, _IONBF, 0);
+#endif
+  m_overwrite = overwrite;
+  m_bufferLength = 0;
+  m_position = 0;
+  m_rawOffset = 0;
+  m_length = overwrite ? 0 : _queryLength();
+
   // reset error
   m_hasError = false;
 }
@@ -66,49 +85,124 @@ void FileWriter::close() {
     return;
   }
 
-  fclose(m_fileHandle);
+  flush();
+  const bool closed = fclose(m_fileHandle) == 0;
   m_fileHandle = nullptr;
 
+  if (!m_overwrite)
+    return;
+
+  // A temporary file that didn't close cleanly may be incomplete; it must not replace the target
   std::string tmpFilename = m_filename + '~';
+  if (!closed) {
+    unlink(tmpFilename.c_str());
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to close file '{}'"), filename());
+    setError();
+    return;
+  }
 #ifdef __SWITCH__
   /* Due to Horizon not being a fully POSIX compatible OS, we need to make sure the file *does not* exist before
    * attempting to rename */
   unlink(m_filename.c_str());
 #endif
-  rename(tmpFilename.c_str(), m_filename.c_str());
+  if (rename(tmpFilename.c_str(), m_filename.c_str()) != 0) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to replace '{}'"), filename());
+    setError();
+  }
 }
 
-void FileWriter::seek(atInt64 pos, SeekOrigin origin) {
-  if (!isOpen()) {
+void FileWriter::discard() {
+  if (!m_fileHandle) {
     if (m_globalErr)
-      atError(FMT_STRING("Unable to seek in file, not open"));
+      atError(FMT_STRING("Cannot close an unopened stream"));
     setError();
     return;
   }
 
-  if (fseeko64(m_fileHandle, pos, int(origin)) != 0) {
-    if (m_globalErr)
-      atError(FMT_STRING("Unable to seek in file"));
-    setError();
+  m_bufferLength = 0;
+  fclose(m_fileHandle);
+  m_fileHandle = nullptr;
+
+  if (m_overwrite) {
+    std::string tmpFilename = m_filename + '~';
+    unlink(tmpFilename.c_str());
   }
 }
 
-atUint64 FileWriter::position() const { return atUint64(ftello64(m_fileHandle)); }
-
-atUint64 FileWriter::length() const { return utility::fileSize(m_filename); }
+#if defined(GEKKO) || defined(__SWITCH__)
+bool FileWriter::_writeAt(atUint64 offset, const atIoSlice* slices, size_t count) {
+  if (offset != m_rawOffset) {
+    if (fseeko64(m_fileHandle, offset, SEEK_SET) != 0) {
+      m_rawOffset = UINT64_MAX;
+      return false;
+    }
+    m_rawOffset = offset;
+  }
 
-void FileWriter::writeUBytes(const atUint8* data, atUint64 len) {
-  if (!isOpen()) {
-    if (m_globalErr)
-      atError(FMT_STRING("File not open for writing"));
-    setError();
-    return;
+  for (size_t i = 0; i < count; ++i) {
+    atUint64 written = fwrite(slices[i].data, 1, slices[i].length, m_fileHandle);
+    m_rawOffset += written;
+    if (written != slices[i].length)
+      return false;
+  }
+  return true;
+}
+#else
+static_assert(sizeof(off_t) >= sizeof(atUint64), "FileWriter needs a 64-bit off_t; build with _FILE_OFFSET_BITS=64");
+
+bool FileWriter::_writeAt(atUint64 offset, const atIoSlice* slices, size_t count) {
+  const int fd = fileno(m_fileHandle);
+  if (offset != m_rawOffset) {
+    if (lseek(fd, off_t(offset), SEEK_SET) < 0) {
+      m_rawOffset = UINT64_MAX;
+      return false;
+    }
+    m_rawOffset = offset;
   }
 
-  if (fwrite(data, 1, len, m_fileHandle) != len) {
-    if (m_globalErr)
-      atError(FMT_STRING("Unable to write to stream"));
-    setError();
+  constexpr size_t MaxSlices = 16;
+  iovec iov[MaxSlices];
+  while (count) {
+    size_t n = std::min(count, MaxSlices);
+    for (size_t i = 0; i < n; ++i) {
+      iov[i].iov_base = const_cast<atUint8*>(slices[i].data);
+      iov[i].iov_len = size_t(slices[i].length);
+    }
+
+    size_t idx = 0;
+    while (idx < n) {
+      ssize_t ret = writev(fd, iov + idx, int(n - idx));
+      if (ret < 0) {
+        if (errno == EINTR)
+          continue;
+        m_rawOffset = UINT64_MAX;
+        return false;
+      }
+      m_rawOffset += atUint64(ret);
+
+      // Step over whatever made it out; a partial write resumes mid-slice
+      size_t rem = size_t(ret);
+      while (idx < n && rem >= iov[idx].iov_len)
+        rem -= iov[idx++].iov_len;
+      if (rem) {
+        iov[idx].iov_base = static_cast<atUint8*>(iov[idx].iov_base) + rem;
+        iov[idx].iov_len -= rem;
+      }
+    }
+
+    slices += n;
+    count -= n;
   }
+  return true;
+}
+#endif
+
+atUint64 FileWriter::_queryLength() const {
+  atStat64_t st;
+  if (atFstat64(fileno(m_fileHandle), &st) != 0)
+    return 0;
+  return atUint64(st.st_size);
 }
 } // namespace athena::io
@@ -1,6 +1,7 @@
 #include "athena/FileWriter.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 
 namespace athena::io {
@@ -50,6 +51,12 @@ void FileWriter::open(bool overwrite) {
     return;
   }
 
+  m_overwrite = overwrite;
+  m_bufferLength = 0;
+  m_position = 0;
+  m_rawOffset = 0;
+  m_length = overwrite ? 0 : _queryLength();
+
   // reset error
   m_hasError = false;
 }
@@ -62,65 +69,84 @@ void FileWriter::close() {
     return;
   }
 
+  flush();
   FlushFileBuffers(m_fileHandle);
-  CloseHandle(m_fileHandle);
+  const bool closed = CloseHandle(m_fileHandle);
   m_fileHandle = 0;
 
-  std::wstring tmpFilename = m_filename + L'~';
-  MoveFileExW(tmpFilename.c_str(), m_filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
-}
+  if (!m_overwrite)
+    return;
 
-void FileWriter::seek(atInt64 pos, SeekOrigin origin) {
-  if (!isOpen()) {
+  // A temporary file that didn't close cleanly may be incomplete; it must not replace the target
+  std::wstring tmpFilename = m_filename + L'~';
+  if (!closed) {
+    DeleteFileW(tmpFilename.c_str());
     if (m_globalErr)
-      atError(FMT_STRING("Unable to seek in file, not open"));
+      atError(FMT_STRING("Unable to close file '{}'"), filename());
     setError();
     return;
   }
-
-  LARGE_INTEGER li;
-  li.QuadPart = pos;
-  if (!SetFilePointerEx(m_fileHandle, li, nullptr, DWORD(origin))) {
+  if (!MoveFileExW(tmpFilename.c_str(), m_filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
     if (m_globalErr)
-      atError(FMT_STRING("Unable to seek in file"));
+      atError(FMT_STRING("Unable to replace '{}'"), filename());
     setError();
   }
 }
 
-atUint64 FileWriter::position() const {
-  LARGE_INTEGER li = {};
-  LARGE_INTEGER res;
-  SetFilePointerEx(m_fileHandle, li, &res, FILE_CURRENT);
-  return static_cast<atUint64>(res.QuadPart);
-}
+void FileWriter::discard() {
+  if (!m_fileHandle) {
+    if (m_globalErr)
+      atError(FMT_STRING("Cannot close an unopened stream"));
+    setError();
+    return;
+  }
 
-atUint64 FileWriter::length() const { return utility::fileSize(m_filename); }
+  m_bufferLength = 0;
+  CloseHandle(m_fileHandle);
+  m_fileHandle = 0;
 
-void FileWriter::writeUBytes(const atUint8* data, atUint64 len) {
-  if (!isOpen()) {
-    if (m_globalErr) {
-      atError(FMT_STRING("File not open for writing"));
+  if (m_overwrite) {
+    std::wstring tmpFilename = m_filename + L'~';
+    DeleteFileW(tmpFilename.c_str());
+  }
+}
+
+bool FileWriter::_writeAt(atUint64 offset, const atIoSlice* slices, size_t count) {
+  if (offset != m_rawOffset) {
+    LARGE_INTEGER li;
+    li.QuadPart = offset;
+    if (!SetFilePointerEx(m_fileHandle, li, nullptr, FILE_BEGIN)) {
+      m_rawOffset = UINT64_MAX;
+      return false;
     }
-    setError();
-    return;
+    m_rawOffset = offset;
   }
 
-  atUint64 remaining = len;
-  do {
-    const auto toWrite = static_cast<DWORD>(std::min(remaining, atUint64{std::numeric_limits<DWORD>::max()}));
-    DWORD written = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const atUint8* data = slices[i].data;
+    atUint64 remaining = slices[i].length;
+    while (remaining != 0) {
+      const auto toWrite = static_cast<DWORD>(std::min(remaining, atUint64{std::numeric_limits<DWORD>::max()}));
+      DWORD written = 0;
 
-    if (WriteFile(m_fileHandle, data, toWrite, &written, nullptr) == FALSE) {
-      if (m_globalErr) {
-        atError(FMT_STRING("Unable to write to file"));
+      if (WriteFile(m_fileHandle, data, toWrite, &written, nullptr) == FALSE) {
+        m_rawOffset = UINT64_MAX;
+        return false;
       }
-      setError();
-      return;
+
+      remaining -= written;
+      data += written;
+      m_rawOffset += written;
     }
+  }
+  return true;
+}
 
-    remaining -= written;
-    data += written;
-  } while (remaining != 0);
+atUint64 FileWriter::_queryLength() const {
+  LARGE_INTEGER res;
+  if (!GetFileSizeEx(m_fileHandle, &res))
+    return 0;
+  return static_cast<atUint64>(res.QuadPart);
 }
 
 } // namespace athena::io
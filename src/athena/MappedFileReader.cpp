@@ -0,0 +1,93 @@
+#include "athena/MappedFileReader.hpp"
+
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace athena::io {
+MappedFileReader::MappedFileReader(std::string_view filename, bool globalErr) : m_filename(filename) {
+  m_globalErr = globalErr;
+  open();
+}
+
+MappedFileReader::MappedFileReader(std::wstring_view filename, bool globalErr)
+: m_filename(utility::wideToUtf8(filename)) {
+  m_globalErr = globalErr;
+  open();
+}
+
+MappedFileReader::~MappedFileReader() {
+  if (isOpen())
+    close();
+}
+
+void MappedFileReader::open() {
+  // Reopening maps the file afresh; the old mapping would otherwise be lost
+  if (m_isOpen)
+    close();
+
+  int fd = ::open(m_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not found '{}'"), m_filename);
+    setError();
+    return;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || atUint64(st.st_size) > SIZE_MAX) {
+    ::close(fd);
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to stat file '{}'"), m_filename);
+    setError();
+    return;
+  }
+
+  m_mappingSize = atUint64(st.st_size);
+  if (m_mappingSize > 0) {
+    void* mapping = mmap(nullptr, size_t(m_mappingSize), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      m_mappingSize = 0;
+      if (m_globalErr)
+        atError(FMT_STRING("Unable to map file '{}'"), m_filename);
+      setError();
+      return;
+    }
+    m_mapping = mapping;
+  }
+
+  // The mapping holds its own reference to the file
+  ::close(fd);
+
+  m_data = m_mapping;
+  m_length = m_mappingSize;
+  m_position = 0;
+  m_isOpen = true;
+
+  // reset error
+  m_hasError = false;
+}
+
+void MappedFileReader::close() {
+  if (!m_isOpen) {
+    if (m_globalErr)
+      atError(FMT_STRING("Cannot close an unopened stream"));
+    setError();
+    return;
+  }
+
+  if (m_mapping)
+    munmap(m_mapping, size_t(m_mappingSize));
+
+  m_mapping = nullptr;
+  m_mappingSize = 0;
+  m_data = nullptr;
+  m_length = 0;
+  m_position = 0;
+  m_isOpen = false;
+}
+} // namespace athena::io
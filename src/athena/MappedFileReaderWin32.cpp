@@ -0,0 +1,106 @@
+#include "athena/MappedFileReader.hpp"
+
+#include <cstdint>
+
+namespace athena::io {
+MappedFileReader::MappedFileReader(std::string_view filename, bool globalErr)
+: m_filename(utility::utf8ToWide(filename)) {
+  m_globalErr = globalErr;
+  open();
+}
+
+MappedFileReader::MappedFileReader(std::wstring_view filename, bool globalErr) : m_filename(filename) {
+  m_globalErr = globalErr;
+  open();
+}
+
+MappedFileReader::~MappedFileReader() {
+  if (isOpen())
+    close();
+}
+
+void MappedFileReader::open() {
+  // Reopening maps the file afresh; the old mapping would otherwise be lost
+  if (m_isOpen)
+    close();
+
+#if WINDOWS_STORE
+  HANDLE fileHandle = CreateFile2(m_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+#else
+  HANDLE fileHandle = CreateFileW(m_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+  if (fileHandle == INVALID_HANDLE_VALUE) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not found '{}'"), filename());
+    setError();
+    return;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(fileHandle, &size) || atUint64(size.QuadPart) > SIZE_MAX) {
+    CloseHandle(fileHandle);
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to stat file '{}'"), filename());
+    setError();
+    return;
+  }
+
+  m_mappingSize = atUint64(size.QuadPart);
+  if (m_mappingSize > 0) {
+#if WINDOWS_STORE
+    m_mappingHandle = CreateFileMappingFromApp(fileHandle, nullptr, PAGE_READONLY, 0, nullptr);
+    if (m_mappingHandle)
+      m_mapping = MapViewOfFileFromApp(m_mappingHandle, FILE_MAP_READ, 0, 0);
+#else
+    m_mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle)
+      m_mapping = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#endif
+    if (!m_mapping) {
+      if (m_mappingHandle)
+        CloseHandle(m_mappingHandle);
+      CloseHandle(fileHandle);
+      m_mappingHandle = nullptr;
+      m_mappingSize = 0;
+      if (m_globalErr)
+        atError(FMT_STRING("Unable to map file '{}'"), filename());
+      setError();
+      return;
+    }
+  }
+
+  // The mapping holds its own reference to the file
+  CloseHandle(fileHandle);
+
+  m_data = m_mapping;
+  m_length = m_mappingSize;
+  m_position = 0;
+  m_isOpen = true;
+
+  // reset error
+  m_hasError = false;
+}
+
+void MappedFileReader::close() {
+  if (!m_isOpen) {
+    if (m_globalErr)
+      atError(FMT_STRING("Cannot close an unopened stream"));
+    setError();
+    return;
+  }
+
+  if (m_mapping)
+    UnmapViewOfFile(m_mapping);
+  if (m_mappingHandle)
+    CloseHandle(m_mappingHandle);
+
+  m_mapping = nullptr;
+  m_mappingHandle = nullptr;
+  m_mappingSize = 0;
+  m_data = nullptr;
+  m_length = 0;
+  m_position = 0;
+  m_isOpen = false;
+}
+} // namespace athena::io
@@ -96,11 +96,16 @@ void MemoryCopyReader::setData(const atUint8* data, atUint64 length) {
 
 atUint8* MemoryReader::data() const {
   atUint8* ret = new atUint8[m_length];
-  memset(ret, 0, m_length);
-  memmove(ret, m_data, m_length);
+  memcpy(ret, m_data, m_length);
   return ret;
 }
 
+std::span<const atUint8> MemoryReader::_contiguousSpan(atUint64 length) {
+  if (m_position >= m_length)
+    return {};
+  return {static_cast<const atUint8*>(m_data) + m_position, size_t(std::min(length, m_length - m_position))};
+}
+
 atUint64 MemoryReader::readUBytesToBuf(void* buf, atUint64 length) {
   if (m_position >= m_length) {
     if (m_globalErr)
@@ -1,5 +1,6 @@
 #include "athena/MemoryWriter.hpp"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 
@@ -38,6 +39,7 @@ MemoryCopyWriter::MemoryCopyWriter(atUint8* data, atUint64 length) {
   }
   m_dataCopy.reset(new atUint8[length]);
   m_data = m_dataCopy.get();
+  m_capacity = length;
   if (data)
     memmove(m_data, data, length);
 }
@@ -48,6 +50,7 @@ MemoryCopyWriter::MemoryCopyWriter(std::string_view filename) {
   m_position = 0;
   m_dataCopy.reset(new atUint8[m_length]);
   m_data = m_dataCopy.get();
+  m_capacity = m_length;
   m_bufferOwned = false;
 
   if (!m_data) {
@@ -167,6 +170,7 @@ void MemoryCopyWriter::setData(const atUint8* data, atUint64 length) {
   m_data = m_dataCopy.get();
   memmove(m_data, data, length);
   m_length = length;
+  m_capacity = length;
   m_position = 0;
   m_bufferOwned = false;
 }
@@ -245,30 +249,70 @@ void MemoryCopyWriter::writeUBytes(const atUint8* data, atUint64 length) {
     return;
   }
 
-  if (m_position + length > m_length)
-    resize(m_position + length);
+  // The position never passes the end, so the new bytes are all about to be overwritten and need no clearing
+  if (m_position + length > m_length) {
+    grow(m_position + length);
+    m_length = m_position + length;
+  }
 
   memmove(m_data + m_position, data, length);
 
   m_position += length;
 }
 
+void MemoryCopyWriter::reserve(atUint64 capacity) {
+  if (capacity <= m_capacity)
+    return;
+
+  std::unique_ptr<atUint8[]> newArray(new atUint8[capacity]);
+  if (m_length)
+    std::memcpy(newArray.get(), m_data, m_length);
+  m_dataCopy = std::move(newArray);
+  m_data = m_dataCopy.get();
+  m_capacity = capacity;
+}
+
+void MemoryCopyWriter::shrinkToFit() {
+  if (m_capacity == m_length)
+    return;
+
+  std::unique_ptr<atUint8[]> newArray;
+  if (m_length) {
+    newArray.reset(new atUint8[m_length]);
+    std::memcpy(newArray.get(), m_data, m_length);
+  }
+  m_dataCopy = std::move(newArray);
+  m_data = m_dataCopy.get();
+  m_capacity = m_length;
+}
+
+std::unique_ptr<atUint8[]> MemoryCopyWriter::release() {
+  std::unique_ptr<atUint8[]> ret = std::move(m_dataCopy);
+  m_data = nullptr;
+  m_length = 0;
+  m_capacity = 0;
+  m_position = 0;
+  return ret;
+}
+
 void MemoryCopyWriter::resize(atUint64 newSize) {
   if (newSize < m_length) {
     atError(FMT_STRING("New size cannot be less to the old size."));
     return;
   }
 
-  // Allocate and copy new buffer
-  auto newArray = std::make_unique<atUint8[]>(newSize);
-  if (m_dataCopy) {
-    std::memmove(newArray.get(), m_dataCopy.get(), m_length);
-  }
-  m_dataCopy = std::move(newArray);
+  if (newSize == m_length)
+    return;
 
-  // Swap the pointer and size out for the new ones.
-  m_data = m_dataCopy.get();
+  grow(newSize);
+  std::memset(m_data + m_length, 0, newSize - m_length);
   m_length = newSize;
 }
 
+void MemoryCopyWriter::grow(atUint64 minCapacity) {
+  // Growing geometrically keeps a long run of small appends linear overall
+  if (minCapacity > m_capacity)
+    reserve(std::max(minCapacity, m_capacity * 2));
+}
+
 } // namespace athena::io
@@ -0,0 +1,207 @@
+#include "athena/PrefetchingFileReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if __linux__ || __APPLE__
+#include <fcntl.h>
+#endif
+
+namespace athena::io {
+PrefetchingFileReader::PrefetchingFileReader(std::string_view filename, atInt32 blockSize, atUint32 blockCount,
+                                             bool globalErr)
+: FileReader(filename, 0, globalErr) {
+  setCacheSize(blockSize, blockCount);
+}
+
+PrefetchingFileReader::PrefetchingFileReader(std::wstring_view filename, atInt32 blockSize, atUint32 blockCount,
+                                             bool globalErr)
+: FileReader(filename, 0, globalErr) {
+  setCacheSize(blockSize, blockCount);
+}
+
+PrefetchingFileReader::~PrefetchingFileReader() { _stop(); }
+
+void PrefetchingFileReader::open() {
+  _stop();
+  FileReader::open();
+  _start();
+}
+
+void PrefetchingFileReader::close() {
+  _stop();
+  FileReader::close();
+}
+
+void PrefetchingFileReader::refreshLength() {
+  _stop();
+  FileReader::refreshLength();
+  _start();
+}
+
+void PrefetchingFileReader::setCacheSize(atInt32 blockSize, atUint32 blockCount) {
+  _stop();
+  m_ringBlockSize = blockSize > 0 ? atUint64(blockSize) : (32 * 1024);
+  m_ring.clear();
+  m_ring.resize(std::max(blockCount, 2u));
+  _start();
+}
+
+void PrefetchingFileReader::_start() {
+  if (!isOpen())
+    return;
+
+#if __linux__
+  posix_fadvise(fileno(m_fileHandle), 0, 0, POSIX_FADV_SEQUENTIAL);
+#elif __APPLE__
+  fcntl(fileno(m_fileHandle), F_RDAHEAD, 1);
+#endif
+
+  for (CacheBlock& slot : m_ring) {
+    if (!slot.data)
+      slot.data.reset(new atUint8[m_ringBlockSize]);
+    slot.index = -1;
+  }
+
+  // No worker is running here, so none of this needs m_mutex; starting the thread publishes it
+  m_prefetchSize = m_fileSize;
+  m_headBlock = 0;
+  m_fetchBlock = 0;
+  ++m_generation;
+  m_stopping = false;
+  m_workerError = false;
+  m_thread = std::thread(&PrefetchingFileReader::_worker, this);
+}
+
+void PrefetchingFileReader::_stop() {
+  if (!m_thread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_stopping = true;
+  }
+  m_workerCv.notify_one();
+  m_thread.join();
+}
+
+void PrefetchingFileReader::_worker() {
+  const atInt64 ringSize = atInt64(m_ring.size());
+  std::unique_lock<std::mutex> lk(m_mutex);
+  for (;;) {
+    m_workerCv.wait(lk, [&] {
+      return m_stopping ||
+             (m_fetchBlock < m_headBlock + ringSize && atUint64(m_fetchBlock) * m_ringBlockSize < m_prefetchSize);
+    });
+    if (m_stopping)
+      return;
+
+    // The slot being claimed held a block behind the reader's head, so nobody is reading from it
+    const atInt64 block = m_fetchBlock++;
+    const atUint64 generation = m_generation;
+    CacheBlock& slot = m_ring[block % ringSize];
+    slot.index = -1;
+    lk.unlock();
+
+    // _readAt would report a failure from this thread; it's handed to the reader instead
+    atUint64 start = atUint64(block) * m_ringBlockSize;
+    atUint64 got;
+    const bool ok = _rawReadAt(start, slot.data.get(), std::min(m_ringBlockSize, m_prefetchSize - start), got);
+
+    lk.lock();
+    if (!ok)
+      m_workerError = true;
+    // A seek may have restarted read-ahead elsewhere while this block was being read
+    if (generation == m_generation) {
+      slot.index = block;
+      slot.size = got;
+      m_readerCv.notify_one();
+    }
+  }
+}
+
+PrefetchingFileReader::CacheBlock& PrefetchingFileReader::_headSlot(std::unique_lock<std::mutex>& lk) {
+  const atInt64 ringSize = atInt64(m_ring.size());
+  const atInt64 block = atInt64(m_offset / m_ringBlockSize);
+
+  if (block < m_headBlock || block >= m_fetchBlock) {
+    // Not covered by the current read-ahead window; restart it here
+    m_headBlock = block;
+    m_fetchBlock = block;
+    ++m_generation;
+    for (CacheBlock& slot : m_ring)
+      slot.index = -1;
+    m_workerCv.notify_one();
+  } else if (block != m_headBlock) {
+    // Blocks behind the reader are free for the worker to refill
+    m_headBlock = block;
+    m_workerCv.notify_one();
+  }
+
+  CacheBlock& slot = m_ring[block % ringSize];
+  if (slot.index != block) {
+    ++m_stallCount;
+    m_readerCv.wait(lk, [&] { return slot.index == block; });
+  }
+  _reportWorkerError();
+  return slot;
+}
+
+void PrefetchingFileReader::_reportWorkerError() {
+  if (!m_workerError)
+    return;
+
+  m_workerError = false;
+  if (m_globalErr)
+    atError(FMT_STRING("Unable to seek in file"));
+  setError();
+}
+
+std::span<const atUint8> PrefetchingFileReader::_contiguousSpan(atUint64 length) {
+  if (!isOpen() || m_offset >= m_fileSize)
+    return {};
+
+  // The worker never writes to the head block's slot, so it stays valid until the reader moves on
+  std::unique_lock<std::mutex> lk(m_mutex);
+  const CacheBlock& slot = _headSlot(lk);
+  const atUint64 cacheOffset = m_offset % m_ringBlockSize;
+  if (cacheOffset >= slot.size)
+    return {};
+  return {slot.data.get() + cacheOffset, size_t(std::min(length, slot.size - cacheOffset))};
+}
+
+atUint64 PrefetchingFileReader::readUBytesToBuf(void* buf, atUint64 len) {
+  if (!isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not open for reading"));
+    setError();
+    return 0;
+  }
+
+  if (m_offset >= m_fileSize)
+    return 0;
+  if (len > m_fileSize - m_offset)
+    len = m_fileSize - m_offset;
+
+  atUint8* dst = reinterpret_cast<atUint8*>(buf);
+  atUint64 rem = len;
+  std::unique_lock<std::mutex> lk(m_mutex);
+  while (rem) {
+    const CacheBlock& slot = _headSlot(lk);
+    const atUint64 cacheOffset = m_offset % m_ringBlockSize;
+    if (cacheOffset >= slot.size)
+      break;
+
+    // The worker never writes to the head block's slot, so it can be copied out unlocked
+    lk.unlock();
+    atUint64 cacheSize = std::min(rem, slot.size - cacheOffset);
+    memcpy(dst, slot.data.get() + cacheOffset, cacheSize);
+    dst += cacheSize;
+    rem -= cacheSize;
+    m_offset += cacheSize;
+    lk.lock();
+  }
+
+  return atUint64(dst - reinterpret_cast<atUint8*>(buf));
+}
+} // namespace athena::io
@@ -0,0 +1,62 @@
+#include "athena/SharedFileReader.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace athena::io {
+static_assert(sizeof(off_t) >= sizeof(atUint64), "SharedFile needs a 64-bit off_t; build with _FILE_OFFSET_BITS=64");
+
+SharedFile::SharedFile(std::string_view filename, bool globalErr) : m_filename(filename), m_globalErr(globalErr) {
+  open();
+}
+
+SharedFile::SharedFile(std::wstring_view filename, bool globalErr)
+: m_filename(utility::wideToUtf8(filename)), m_globalErr(globalErr) {
+  open();
+}
+
+SharedFile::~SharedFile() {
+  if (m_fileHandle >= 0)
+    ::close(m_fileHandle);
+}
+
+void SharedFile::open() {
+  m_fileHandle = ::open(m_filename.c_str(), O_RDONLY);
+  if (m_fileHandle < 0) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not found '{}'"), m_filename);
+    return;
+  }
+
+  struct stat st;
+  if (fstat(m_fileHandle, &st) != 0) {
+    ::close(m_fileHandle);
+    m_fileHandle = -1;
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to stat file '{}'"), m_filename);
+    return;
+  }
+
+  m_length = atUint64(st.st_size);
+  m_isOpen = true;
+}
+
+atUint64 SharedFile::readAt(atUint64 offset, void* buf, atUint64 len) const {
+  atUint8* dst = reinterpret_cast<atUint8*>(buf);
+  atUint64 rem = len;
+  while (rem) {
+    ssize_t ret = pread(m_fileHandle, dst, rem, off_t(offset));
+    if (ret < 0 && errno == EINTR)
+      continue;
+    if (ret <= 0)
+      break;
+    dst += ret;
+    rem -= atUint64(ret);
+    offset += atUint64(ret);
+  }
+  return len - rem;
+}
+} // namespace athena::io
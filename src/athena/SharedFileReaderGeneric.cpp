@@ -0,0 +1,114 @@
+#include "athena/SharedFileReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace athena::io {
+SharedFileReader::SharedFileReader(std::shared_ptr<const SharedFile> file, atUint64 offset, atUint64 length,
+                                   atUint32 bufferSize, bool globalErr)
+: m_file(std::move(file)), m_base(offset), m_bufferSize(bufferSize), m_globalErr(globalErr) {
+  if (!m_file || !m_file->isOpen()) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not open for reading"));
+    setError();
+    return;
+  }
+
+  const atUint64 fileLength = m_file->length();
+  if (m_base > fileLength)
+    m_base = fileLength;
+  m_length = std::min(length, fileLength - m_base);
+
+  if (m_bufferSize > 0)
+    m_buffer.reset(new atUint8[m_bufferSize]);
+}
+
+void SharedFileReader::seek(atInt64 pos, SeekOrigin origin) {
+  atInt64 position = 0;
+  switch (origin) {
+  case SeekOrigin::Begin:
+    position = pos;
+    break;
+  case SeekOrigin::Current:
+    position = atInt64(m_position) + pos;
+    break;
+  case SeekOrigin::End:
+    position = atInt64(m_length) - pos;
+    break;
+  }
+
+  if (position < 0 || atUint64(position) > m_length) {
+    if (m_globalErr)
+      atError(FMT_STRING("Position {:08X} outside stream bounds "), position);
+    m_position = position < 0 ? 0 : m_length;
+    setError();
+    return;
+  }
+
+  m_position = atUint64(position);
+}
+
+atUint64 SharedFileReader::readUBytesToBuf(void* buf, atUint64 len) {
+  if (m_position >= m_length) {
+    if (m_globalErr)
+      atError(FMT_STRING("Position {:08X} outside stream bounds "), m_position);
+    m_position = m_length;
+    setError();
+    return 0;
+  }
+
+  len = std::min(len, m_length - m_position);
+  atUint8* dst = reinterpret_cast<atUint8*>(buf);
+  atUint64 rem = len;
+
+  // Whatever is already buffered at the current position
+  if (m_position >= m_bufferStart && m_position < m_bufferStart + m_bufferFill) {
+    atUint64 avail = std::min(rem, m_bufferStart + m_bufferFill - m_position);
+    memcpy(dst, m_buffer.get() + (m_position - m_bufferStart), avail);
+    dst += avail;
+    rem -= avail;
+    m_position += avail;
+  }
+
+  if (rem >= m_bufferSize) {
+    // Large reads skip the buffer entirely
+    atUint64 got = m_file->readAt(m_base + m_position, dst, rem);
+    dst += got;
+    rem -= got;
+    m_position += got;
+  } else if (rem) {
+    atUint64 want = std::min(m_bufferSize, m_length - m_position);
+    m_bufferStart = m_position;
+    m_bufferFill = m_file->readAt(m_base + m_position, m_buffer.get(), want);
+    atUint64 avail = std::min(rem, m_bufferFill);
+    memcpy(dst, m_buffer.get(), avail);
+    dst += avail;
+    rem -= avail;
+    m_position += avail;
+  }
+
+  if (rem) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to read from file '{}'"), m_file->filename());
+    setError();
+  }
+
+  return len - rem;
+}
+
+std::span<const atUint8> SharedFileReader::_contiguousSpan(atUint64 length) {
+  if (m_position >= m_length || length > m_bufferSize)
+    return {};
+
+  if (m_position < m_bufferStart || m_position + length > m_bufferStart + m_bufferFill) {
+    atUint64 want = std::min(m_bufferSize, m_length - m_position);
+    m_bufferStart = m_position;
+    m_bufferFill = m_file->readAt(m_base + m_position, m_buffer.get(), want);
+  }
+
+  if (m_position >= m_bufferStart + m_bufferFill)
+    return {};
+  return {m_buffer.get() + (m_position - m_bufferStart),
+          size_t(std::min(length, m_bufferStart + m_bufferFill - m_position))};
+}
+} // namespace athena::io
@@ -0,0 +1,62 @@
+#include "athena/SharedFileReader.hpp"
+
+namespace athena::io {
+SharedFile::SharedFile(std::string_view filename, bool globalErr)
+: m_filename(utility::utf8ToWide(filename)), m_globalErr(globalErr) {
+  open();
+}
+
+SharedFile::SharedFile(std::wstring_view filename, bool globalErr) : m_filename(filename), m_globalErr(globalErr) {
+  open();
+}
+
+SharedFile::~SharedFile() {
+  if (m_fileHandle != INVALID_HANDLE_VALUE)
+    CloseHandle(m_fileHandle);
+}
+
+void SharedFile::open() {
+#if WINDOWS_STORE
+  m_fileHandle = CreateFile2(m_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+#else
+  m_fileHandle = CreateFileW(m_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+  if (m_fileHandle == INVALID_HANDLE_VALUE) {
+    if (m_globalErr)
+      atError(FMT_STRING("File not found '{}'"), filename());
+    return;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_fileHandle, &size)) {
+    CloseHandle(m_fileHandle);
+    m_fileHandle = INVALID_HANDLE_VALUE;
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to stat file '{}'"), filename());
+    return;
+  }
+
+  m_length = atUint64(size.QuadPart);
+  m_isOpen = true;
+}
+
+atUint64 SharedFile::readAt(atUint64 offset, void* buf, atUint64 len) const {
+  atUint8* dst = reinterpret_cast<atUint8*>(buf);
+  atUint64 rem = len;
+  while (rem) {
+    // An explicit offset makes the read independent of the handle's file pointer
+    OVERLAPPED ov = {};
+    ov.Offset = DWORD(offset);
+    ov.OffsetHigh = DWORD(offset >> 32);
+    DWORD toRead = rem > 0x80000000 ? 0x80000000 : DWORD(rem);
+    DWORD readSz = 0;
+    if (!ReadFile(m_fileHandle, dst, toRead, &readSz, &ov) || readSz == 0)
+      break;
+    dst += readSz;
+    rem -= readSz;
+    offset += readSz;
+  }
+  return len - rem;
+}
+} // namespace athena::io
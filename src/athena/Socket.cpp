@@ -8,6 +8,7 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
 #else
@@ -15,7 +16,12 @@
 #include <Ws2tcpip.h>
 #endif
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
 #include "athena/Global.hpp"
+#include "athena/Types.hpp"
 
 namespace athena::net {
 
@@ -238,6 +244,75 @@ Socket::EResult Socket::send(const void* buf, size_t len) {
   return send(buf, len, transferred);
 }
 
+Socket::EResult Socket::send(const atIoSlice* slices, size_t count, size_t& transferred) {
+  transferred = 0;
+  if (!isOpen())
+    return EResult::Error;
+
+  /* Nothing to send is an error, same as send(buf, 0) */
+  atUint64 total = 0;
+  for (size_t i = 0; slices && i < count; ++i)
+    total += slices[i].length;
+  if (!slices || !total)
+    return EResult::Error;
+
+  /* Send up to MaxSlices buffers per call, picking up mid-buffer after a partial send */
+  constexpr size_t MaxSlices = 64;
+#ifndef _WIN32
+  iovec iov[MaxSlices];
+  constexpr atUint64 MaxBufLen = SIZE_MAX;
+#else
+  WSABUF iov[MaxSlices];
+  constexpr atUint64 MaxBufLen = ULONG_MAX;
+#endif
+  size_t next = 0;
+  atUint64 offset = 0;
+  while (next < count) {
+    size_t n = 0;
+    for (size_t i = next; i < count && n < MaxSlices; ++i) {
+      const atUint64 skip = i == next ? offset : 0;
+      const atUint64 len = std::min(slices[i].length - skip, MaxBufLen);
+#ifndef _WIN32
+      iov[n].iov_base = const_cast<atUint8*>(slices[i].data + skip);
+      iov[n].iov_len = size_t(len);
+#else
+      iov[n].buf = reinterpret_cast<CHAR*>(const_cast<atUint8*>(slices[i].data + skip));
+      iov[n].len = ULONG(len);
+#endif
+      ++n;
+      /* A buffer too long for one call ends the batch; the partial-send resume below sends the rest of it */
+      if (len != slices[i].length - skip)
+        break;
+    }
+
+#ifndef _WIN32
+    msghdr msg = {};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = n;
+    ssize_t result = ::sendmsg(m_socket, &msg, _flags);
+    if (result < 0)
+      return (errno == EAGAIN) ? EResult::Busy : EResult::Error;
+#else
+    DWORD result = 0;
+    if (WSASend(m_socket, iov, DWORD(n), &result, 0, nullptr, nullptr) == SOCKET_ERROR)
+      return LastWSAError();
+#endif
+
+    transferred += size_t(result);
+    atUint64 rem = atUint64(result) + offset;
+    while (next < count && rem >= slices[next].length)
+      rem -= slices[next++].length;
+    offset = rem;
+  }
+
+  return EResult::OK;
+}
+
+Socket::EResult Socket::send(const atIoSlice* slices, size_t count) {
+  size_t transferred;
+  return send(slices, count, transferred);
+}
+
 Socket::EResult Socket::recv(void* buf, size_t len, size_t& transferred) {
   transferred = 0;
   if (!isOpen())
@@ -1,6 +1,7 @@
 ﻿#include "athena/Utility.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
@@ -18,8 +19,175 @@
 #include <locale>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ATHENA_SWAP_SSE2 1
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__AVX2__)
+#include <immintrin.h>
+#define ATHENA_SWAP_AVX2_DISPATCH 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ATHENA_SWAP_NEON 1
+#endif
+
 namespace athena::utility {
 
+namespace {
+template <class T, T (*Swap)(T)>
+void swapCopyScalar(atUint8* dst, const atUint8* src, atUint64 count) {
+  for (atUint64 i = 0; i < count; ++i) {
+    T v;
+    memcpy(&v, src + i * sizeof(T), sizeof(T));
+    v = Swap(v);
+    memcpy(dst + i * sizeof(T), &v, sizeof(T));
+  }
+}
+
+#if ATHENA_SWAP_SSE2
+/* Swaps the bytes of each 16-bit lane */
+inline __m128i swapLanes16(__m128i v) { return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)); }
+
+template <int Size>
+inline __m128i swapLanes(__m128i v) {
+  if constexpr (Size == 4) {
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+  } else if constexpr (Size == 8) {
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+  }
+  return swapLanes16(v);
+}
+
+template <int Size>
+atUint64 swapCopySSE2(atUint8* dst, const atUint8* src, atUint64 count) {
+  const atUint64 vecs = count * Size / 16;
+  for (atUint64 i = 0; i < vecs; ++i) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 16), swapLanes<Size>(v));
+  }
+  return vecs * 16 / Size;
+}
+#endif
+
+#if ATHENA_SWAP_AVX2_DISPATCH || defined(__AVX2__)
+template <int Size>
+#if ATHENA_SWAP_AVX2_DISPATCH
+__attribute__((target("avx2")))
+#endif
+atUint64 swapCopyAVX2(atUint8* dst, const atUint8* src, atUint64 count) {
+  const __m256i mask = Size == 2   ? _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5,
+                                                        4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+                       : Size == 4 ? _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7,
+                                                        6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+                                   : _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3,
+                                                        2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  const atUint64 vecs = count * Size / 32;
+  for (atUint64 i = 0; i < vecs; ++i) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 32), _mm256_shuffle_epi8(v, mask));
+  }
+  return vecs * 32 / Size;
+}
+#endif
+
+#if ATHENA_SWAP_AVX2_DISPATCH
+const bool HasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+
+#if ATHENA_SWAP_NEON
+template <int Size>
+atUint64 swapCopyNEON(atUint8* dst, const atUint8* src, atUint64 count) {
+  const atUint64 vecs = count * Size / 16;
+  for (atUint64 i = 0; i < vecs; ++i) {
+    uint8x16_t v = vld1q_u8(src + i * 16);
+    if constexpr (Size == 2)
+      v = vrev16q_u8(v);
+    else if constexpr (Size == 4)
+      v = vrev32q_u8(v);
+    else
+      v = vrev64q_u8(v);
+    vst1q_u8(dst + i * 16, v);
+  }
+  return vecs * 16 / Size;
+}
+#endif
+
+/* Runs the widest kernel available over the bulk of the array, then finishes the tail one unit at a time */
+template <int Size, class T, T (*Swap)(T)>
+void swapCopy(void* dstv, const void* srcv, atUint64 count) {
+  auto* dst = static_cast<atUint8*>(dstv);
+  const auto* src = static_cast<const atUint8*>(srcv);
+  atUint64 done = 0;
+#if defined(__AVX2__)
+  done = swapCopyAVX2<Size>(dst, src, count);
+#elif ATHENA_SWAP_AVX2_DISPATCH
+  if (HasAVX2)
+    done = swapCopyAVX2<Size>(dst, src, count);
+#endif
+#if ATHENA_SWAP_SSE2
+  done += swapCopySSE2<Size>(dst + done * Size, src + done * Size, count - done);
+#elif ATHENA_SWAP_NEON
+  done = swapCopyNEON<Size>(dst, src, count);
+#endif
+  swapCopyScalar<T, Swap>(dst + done * Size, src + done * Size, count - done);
+}
+} // namespace
+
+void swapCopy16(void* dst, const void* src, atUint64 count) { swapCopy<2, atUint16, swapU16>(dst, src, count); }
+void swapCopy32(void* dst, const void* src, atUint64 count) { swapCopy<4, atUint32, swapU32>(dst, src, count); }
+void swapCopy64(void* dst, const void* src, atUint64 count) { swapCopy<8, atUint64, swapU64>(dst, src, count); }
+
+atUint64 findZero16(const void* datav, atUint64 count) {
+  const auto* data = static_cast<const atUint8*>(datav);
+  atUint64 i = 0;
+#if ATHENA_SWAP_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    const int mask =
+        _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 2)), zero));
+    if (mask)
+      return i + std::countr_zero(unsigned(mask)) / 2;
+  }
+#elif ATHENA_SWAP_NEON
+  for (; i + 8 <= count; i += 8) {
+    if (vminvq_u16(vreinterpretq_u16_u8(vld1q_u8(data + i * 2))) == 0)
+      break;
+  }
+#endif
+  for (; i < count; ++i)
+    if (data[i * 2] == 0 && data[i * 2 + 1] == 0)
+      return i;
+  return count;
+}
+
+atUint64 findZero32(const void* datav, atUint64 count) {
+  const auto* data = static_cast<const atUint8*>(datav);
+  atUint64 i = 0;
+#if ATHENA_SWAP_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 4 <= count; i += 4) {
+    const int mask =
+        _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4)), zero));
+    if (mask)
+      return i + std::countr_zero(unsigned(mask)) / 4;
+  }
+#elif ATHENA_SWAP_NEON
+  for (; i + 4 <= count; i += 4) {
+    if (vminvq_u32(vreinterpretq_u32_u8(vld1q_u8(data + i * 4))) == 0)
+      break;
+  }
+#endif
+  for (; i < count; ++i) {
+    atUint32 v;
+    memcpy(&v, data + i * 4, 4);
+    if (v == 0)
+      return i;
+  }
+  return count;
+}
+
 void fillRandom(atUint8* rndArea, atUint64 count) {
   atUint8* buf = rndArea;
   for (atUint64 i = 0; i < count / 4; i++) {
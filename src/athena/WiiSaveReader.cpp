@@ -84,7 +84,7 @@ std::unique_ptr<WiiSave> WiiSaveReader::readSave() {
 WiiBanner* WiiSaveReader::readBanner() {
   atUint8* dec = new atUint8[0xF0C0];
   memset(dec, 0, 0xF0C0);
-  std::unique_ptr<atUint8[]> buf = readUBytes(0xF0C0);
+  auto buf = readUBytesPooled(0xF0C0);
   atUint8* oldData = data();
   atUint64 oldPos = position();
   atUint64 oldLen = length();
@@ -249,7 +249,7 @@ WiiFile* WiiSaveReader::readFile() {
   if (type == WiiFile::File) {
     // Read file data
     int roundedLen = (fileLen + 63) & ~63;
-    std::unique_ptr<atUint8[]> filedata = readUBytes(roundedLen);
+    auto filedata = readUBytesPooled(roundedLen);
 
     // Decrypt file
     std::cout << "Decrypting: " << ret->filename() << "...";
@@ -272,7 +272,7 @@ void WiiSaveReader::readCerts(atUint32 totalSize) {
   std::unique_ptr<atUint8[]> ngCert = readUBytes(0x180);
   std::unique_ptr<atUint8[]> apCert = readUBytes(0x180);
   seek(0xF0C0, SeekOrigin::Begin);
-  std::unique_ptr<atUint8[]> data = readUBytes(dataSize);
+  auto data = readUBytesPooled(dataSize);
   atUint8* hash;
 
   std::cout << "validating..." << std::endl;
@@ -2,6 +2,7 @@
 #include "athena/ZQuestFile.hpp"
 #include "athena/Compression.hpp"
 #include "athena/Checksums.hpp"
+#include "athena/ZlibWriter.hpp"
 
 namespace athena::io {
 
@@ -17,45 +18,47 @@ void ZQuestFileWriter::write(ZQuestFile* quest, bool compress) {
 
   writeUint32(ZQuestFile::Magic);
   writeUint32(ZQuestFile::Version);
-  atUint8* questData = quest->data();
-  atUint32 compLen;
+  const atUint8* questData = quest->data();
+  const atUint32 questLen = quest->length();
 
-  if (compress) {
-    atUint8* compData =
-        new atUint8[quest->length() + 0x40]; // add 20 bytes because sometimes the file grows with compression
-    compLen = quest->length() + 0x40;
-    compLen = io::Compression::compressZlib(questData, quest->length(), compData, compLen);
+  // The stored length and checksum are patched in once the data has been written
+  const atUint64 compLenPos = position();
+  writeUint32(questLen);
+  writeUint32(questLen);
+  writeBytes((atInt8*)quest->gameString().substr(0, 0x0A).c_str(), 0x0A);
+  writeUint16(quest->endian() == Endian::Big ? 0xFFFE : 0xFEFF);
+  const atUint64 checksumPos = position();
+  writeUint32(0);
+  const atUint64 dataStart = position();
+
+  atUint32 compLen = questLen;
+  // Data that samples as incompressible (already packed, encrypted) is stored without trying
+  if (compress && Compression::worthCompressing(questData, questLen)) {
+    // Deflate straight into this writer instead of through a second full-size buffer
+    ZlibWriter zlib(*this, 9);
+    zlib.writeUBytes(questData, questLen);
+    zlib.finish();
 
     // if the compressed data is the same length or larger than the original data, just store the original
-    if (compLen >= quest->length() || compLen <= 0) {
-      compLen = quest->length();
-      // Delete the compressed data since we won't be using it
-      delete[] compData;
-      compData = NULL;
-      writeUint32(quest->length());
+    if (zlib.hasError() || zlib.compressedLength() >= questLen) {
+      seek(dataStart, SeekOrigin::Begin);
+      writeUBytes(questData, questLen);
+      m_length = dataStart + questLen;
     } else {
-      // Don't do delete on data
-      questData = compData;
-      writeUint32(compLen);
+      compLen = atUint32(zlib.compressedLength());
     }
   } else {
-    compLen = quest->length();
-    writeUint32(quest->length());
+    writeUBytes(questData, questLen);
   }
 
-  writeUint32(quest->length());
-  writeBytes((atInt8*)quest->gameString().substr(0, 0x0A).c_str(), 0x0A);
-  writeUint16(quest->endian() == Endian::Big ? 0xFFFE : 0xFEFF);
-  writeUint32(athena::checksums::crc32(questData, compLen));
-  writeUBytes(questData, compLen);
+  const atUint32 checksum = athena::checksums::crc32(m_data + dataStart, compLen);
+  seek(compLenPos, SeekOrigin::Begin);
+  writeUint32(compLen);
+  seek(checksumPos, SeekOrigin::Begin);
+  writeUint32(checksum);
+  seek(dataStart + compLen, SeekOrigin::Begin);
 
   save();
-
-  // Delete compressed data to prevent memory leaks
-  if (questData != quest->data()) {
-    delete[] questData;
-    questData = NULL;
-  }
 }
 
 } // namespace athena::io
@@ -0,0 +1,191 @@
+#include "athena/ZlibReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <zlib.h>
+
+namespace athena::io {
+ZlibReader::ZlibReader(IStreamReader& source, atUint64 compressedLength, atUint64 uncompressedLength,
+                       atUint32 bufferSize, bool globalErr)
+: m_source(&source)
+, m_strm(std::make_unique<z_stream_s>())
+, m_inBuf(new atUint8[std::max(bufferSize, 1u)])
+, m_window(new atUint8[std::max(bufferSize, 1u) + History])
+, m_bufferSize(std::max(bufferSize, 1u))
+, m_globalErr(globalErr) {
+  // 15 window bits, and the | 32 tells zlib to detect if using gzip or zlib
+  m_streamOk = inflateInit2(m_strm.get(), MAX_WBITS | 32) == Z_OK;
+  if (!m_streamOk) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to initialize zlib"));
+    setError();
+    return;
+  }
+
+  reset(source, compressedLength, uncompressedLength);
+}
+
+ZlibReader::~ZlibReader() {
+  if (m_streamOk)
+    inflateEnd(m_strm.get());
+}
+
+void ZlibReader::reset(IStreamReader& source, atUint64 compressedLength, atUint64 uncompressedLength) {
+  m_source = &source;
+  m_sourceStart = source.position();
+  m_compressedLength = compressedLength;
+  m_length = uncompressedLength;
+  _rewind();
+}
+
+void ZlibReader::seek(atInt64 pos, SeekOrigin origin) {
+  atInt64 target = pos;
+  if (origin == SeekOrigin::Current)
+    target = atInt64(m_position) + pos;
+  else if (origin == SeekOrigin::End)
+    target = atInt64(m_length) - pos;
+
+  if (target < 0 || atUint64(target) > m_length) {
+    if (m_globalErr)
+      atError(FMT_STRING("Position {:08X} outside stream bounds "), target);
+    setError();
+    return;
+  }
+
+  // Anywhere inside the window is free; only before it does the stream have to start over
+  if (atUint64(target) < m_windowStart)
+    _rewind();
+
+  // There is no way to jump ahead in a deflate stream, so whatever lies in between is decompressed and dropped
+  while (atUint64(target) > m_windowStart + m_windowLen) {
+    m_position = m_windowStart + m_windowLen;
+    if (!_fill())
+      break;
+  }
+  m_position = std::min<atUint64>(atUint64(target), m_windowStart + m_windowLen);
+}
+
+atUint64 ZlibReader::readUBytesToBuf(void* buf, atUint64 len) {
+  if (len > m_length - m_position) {
+    if (m_globalErr)
+      atError(FMT_STRING("Position {:08X} outside stream bounds "), m_position);
+    setError();
+    len = m_length - m_position;
+  }
+
+  auto* dst = static_cast<atUint8*>(buf);
+  atUint64 done = 0;
+  while (done < len) {
+    const atUint64 windowEnd = m_windowStart + m_windowLen;
+    if (m_position < windowEnd) {
+      const atUint64 count = std::min(len - done, windowEnd - m_position);
+      memcpy(dst + done, m_window.get() + (m_position - m_windowStart), count);
+      m_position += count;
+      done += count;
+      continue;
+    }
+
+    if (len - done < m_bufferSize) {
+      if (!_fill())
+        break;
+      continue;
+    }
+
+    // Large reads inflate straight into the caller's buffer; its tail is kept as history for short seeks back
+    const atUint64 got = _inflate(dst + done, len - done);
+    if (!got)
+      break;
+    done += got;
+    m_position += got;
+    const atUint64 history = std::min(got, History);
+    memcpy(m_window.get(), dst + done - history, history);
+    m_windowStart = m_decoded - history;
+    m_windowLen = history;
+  }
+  return done;
+}
+
+std::span<const atUint8> ZlibReader::_contiguousSpan(atUint64 length) {
+  while (m_windowStart + m_windowLen - m_position < length) {
+    if (!_fill())
+      break;
+  }
+  const atUint64 avail = m_windowStart + m_windowLen - m_position;
+  return {m_window.get() + (m_position - m_windowStart), size_t(std::min(length, avail))};
+}
+
+void ZlibReader::_rewind() {
+  m_position = 0;
+  m_decoded = 0;
+  m_windowStart = 0;
+  m_windowLen = 0;
+  if (!m_streamOk)
+    return;
+
+  inflateReset(m_strm.get());
+  m_strm->next_in = nullptr;
+  m_strm->avail_in = 0;
+  m_compressedRead = 0;
+  if (m_source->position() != m_sourceStart)
+    m_source->seek(m_sourceStart, SeekOrigin::Begin);
+}
+
+bool ZlibReader::_fill() {
+  if (m_decoded >= m_length)
+    return false;
+
+  // Keep what hasn't been read yet, plus up to History bytes before the position
+  const atUint64 keepFrom = std::max(m_windowStart, m_position > History ? m_position - History : 0);
+  const atUint64 kept = m_decoded - keepFrom;
+  memmove(m_window.get(), m_window.get() + (keepFrom - m_windowStart), kept);
+  m_windowStart = keepFrom;
+  m_windowLen = kept;
+
+  const atUint64 room = std::min<atUint64>(m_bufferSize + History - kept, m_length - m_decoded);
+  const atUint64 got = room ? _inflate(m_window.get() + kept, room) : 0;
+  m_windowLen += got;
+  return got != 0;
+}
+
+atUint64 ZlibReader::_inflate(atUint8* dst, atUint64 len) {
+  if (!m_streamOk)
+    return 0;
+
+  m_strm->next_out = dst;
+  m_strm->avail_out = uInt(std::min<atUint64>(len, 0x40000000));
+  const uInt wanted = m_strm->avail_out;
+
+  while (m_strm->avail_out) {
+    if (!m_strm->avail_in && m_compressedRead < m_compressedLength) {
+      atUint64 want = std::min<atUint64>(m_bufferSize, m_compressedLength - m_compressedRead);
+      atUint64 got = m_source->readUBytesToBuf(m_inBuf.get(), want);
+      m_compressedRead += got;
+      m_strm->next_in = m_inBuf.get();
+      m_strm->avail_in = uInt(got);
+      if (got != want)
+        m_compressedLength = m_compressedRead;
+    }
+
+    int ret = inflate(m_strm.get(), Z_NO_FLUSH);
+    if (ret == Z_STREAM_END) {
+      if (m_strm->avail_out) {
+        if (m_globalErr)
+          atError(FMT_STRING("Compressed stream ended at {:08X}"), m_decoded + (wanted - m_strm->avail_out));
+        setError();
+      }
+      break;
+    }
+    if (ret != Z_OK && !(ret == Z_BUF_ERROR && m_strm->avail_in == 0 && m_compressedRead < m_compressedLength)) {
+      if (m_globalErr)
+        atError(FMT_STRING("Error decompressing data: {}"), m_strm->msg ? m_strm->msg : "truncated stream");
+      setError();
+      break;
+    }
+  }
+
+  const atUint64 produced = wanted - m_strm->avail_out;
+  m_decoded += produced;
+  return produced;
+}
+} // namespace athena::io
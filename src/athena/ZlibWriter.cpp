@@ -0,0 +1,127 @@
+#include "athena/ZlibWriter.hpp"
+
+#include <algorithm>
+
+#include <zlib.h>
+
+namespace athena::io {
+ZlibWriter::ZlibWriter(IStreamWriter& sink, atInt32 level, atInt32 strategy, atUint32 bufferSize, bool globalErr)
+: m_sink(&sink)
+, m_strm(std::make_unique<z_stream_s>())
+, m_outBuf(new atUint8[std::max(bufferSize, 1u)])
+, m_bufferSize(std::max(bufferSize, 1u))
+, m_globalErr(globalErr) {
+  m_streamOk = deflateInit2(m_strm.get(), level, Z_DEFLATED, MAX_WBITS, 8, strategy) == Z_OK;
+  if (!m_streamOk) {
+    if (m_globalErr)
+      atError(FMT_STRING("Unable to initialize zlib with level {} and strategy {}"), level, strategy);
+    setError();
+  }
+}
+
+ZlibWriter::~ZlibWriter() {
+  if (!m_streamOk)
+    return;
+  if (!m_finished)
+    finish();
+  deflateEnd(m_strm.get());
+}
+
+void ZlibWriter::reset(IStreamWriter& sink) {
+  if (!m_streamOk)
+    return;
+  if (!m_finished)
+    finish();
+
+  deflateReset(m_strm.get());
+  m_sink = &sink;
+  m_position = 0;
+  m_compressedLength = 0;
+  m_finished = false;
+}
+
+void ZlibWriter::finish() {
+  if (!m_streamOk || m_finished)
+    return;
+  _deflate(nullptr, 0, Z_FINISH);
+  m_finished = true;
+}
+
+void ZlibWriter::seek(atInt64 pos, SeekOrigin origin) {
+  atInt64 target = pos;
+  if (origin == SeekOrigin::Current)
+    target = atInt64(m_position) + pos;
+  else if (origin == SeekOrigin::End)
+    target = atInt64(m_position) - pos;
+
+  if (target < atInt64(m_position)) {
+    if (m_globalErr)
+      atError(FMT_STRING("Cannot seek backwards in a compressed stream"));
+    setError();
+    return;
+  }
+
+  static constexpr atUint8 Zeros[4096] = {};
+  while (m_position < atUint64(target)) {
+    const atUint64 count = std::min<atUint64>(sizeof(Zeros), atUint64(target) - m_position);
+    writeUBytes(Zeros, count);
+    if (hasError())
+      return;
+  }
+}
+
+void ZlibWriter::writeUBytes(const atUint8* data, atUint64 length) {
+  if (!data) {
+    if (m_globalErr)
+      atError(FMT_STRING("data cannnot be NULL"));
+    setError();
+    return;
+  }
+
+  if (m_finished) {
+    if (m_globalErr)
+      atError(FMT_STRING("Cannot write to a finished compressed stream"));
+    setError();
+    return;
+  }
+
+  if (_deflate(data, length, Z_NO_FLUSH))
+    m_position += length;
+}
+
+bool ZlibWriter::_deflate(const atUint8* data, atUint64 length, int flush) {
+  if (!m_streamOk)
+    return false;
+
+  m_strm->next_in = const_cast<Bytef*>(data);
+  do {
+    // avail_in is only 32 bits wide, so very large writes are fed in pieces
+    const uInt piece = uInt(std::min<atUint64>(length, 0x40000000));
+    m_strm->avail_in = piece;
+    length -= piece;
+    const int pieceFlush = length ? Z_NO_FLUSH : flush;
+
+    int ret;
+    do {
+      m_strm->next_out = m_outBuf.get();
+      m_strm->avail_out = m_bufferSize;
+      ret = deflate(m_strm.get(), pieceFlush);
+      if (ret == Z_STREAM_ERROR) {
+        if (m_globalErr)
+          atError(FMT_STRING("Error compressing data: {}"), m_strm->msg ? m_strm->msg : "stream error");
+        setError();
+        return false;
+      }
+
+      const atUint64 produced = m_bufferSize - m_strm->avail_out;
+      if (produced) {
+        m_sink->writeUBytes(m_outBuf.get(), produced);
+        m_compressedLength += produced;
+      }
+      // An output buffer left with room means deflate has nothing more to give for now
+    } while (m_strm->avail_out == 0 || (pieceFlush == Z_FINISH && ret != Z_STREAM_END));
+  } while (length);
+
+  return true;
+}
+} // namespace athena::io